@@ -2,14 +2,46 @@
 #include "AD74413R.h"
 
 
+// поле DIAG_ASSIGN слота: код источника - AD74413R_DIAGNOSTIC_MODE без DIAG_OFF
+#define DIAG_ASSIGN_SHIFT(diagId)									((diagId)*BITP_DIAG_ASSIGN_DIAG1_ASSIGN)
+#define DIAG_ASSIGN_GET(assign, diagId)						(((assign) >> DIAG_ASSIGN_SHIFT(diagId)) & BITM_DIAG_ASSIGN_DIAG0_ASSIGN)
+#define DIAG_ASSIGN_SET(assign, diagId, diagMode)	(((assign) & ~(BITM_DIAG_ASSIGN_DIAG0_ASSIGN << DIAG_ASSIGN_SHIFT(diagId))) \
+																									| ((((diagMode)-1) & BITM_DIAG_ASSIGN_DIAG0_ASSIGN) << DIAG_ASSIGN_SHIFT(diagId)))
+
+// кадров в пакете профиля: остановка АЦП, по два кадра на перевод канала
+// в HIGH_IMP и на новую функцию, DIAG_ASSIGN; пакет передаётся в два этапа
+// с выдержкой AD74413R_HIGH_IMP_SETTLE_US между ними
+#define PROFILE_MAX_FRAMES		(2 + 4*AD74413R_NUMBER_OF_CHANNELS)
+// регистры, проверяемые одним чтением после записи профиля
+#define PROFILE_READBACK_FIRST	AD74413_REG_CH_FUNC_SETUP0
+#define PROFILE_READBACK_COUNT	(AD74413_REG_DIN_CONFIG3 - AD74413_REG_CH_FUNC_SETUP0 + 1)
+
+// конфигурация чипа при восстановлении: GPO_PARALLEL, по RECOVERY_CH_FRAMES
+// регистров на канал, DIN_THRESH, DIAG_ASSIGN, ALERT_MASK
+#define RECOVERY_CH_FIRST				1
+#define RECOVERY_CH_FRAMES			7
+#define RECOVERY_CONFIG_FRAMES	(4 + RECOVERY_CH_FRAMES*AD74413R_NUMBER_OF_CHANNELS)
+// кадров в пакете восстановления: дополнительно остановка АЦП и перевод
+// каналов в HIGH_IMP
+#define RECOVERY_MAX_FRAMES			(1 + 2*AD74413R_NUMBER_OF_CHANNELS + RECOVERY_CONFIG_FRAMES)
+// регистры, сверяемые одним чтением при восстановлении; ALERT_MASK - отдельно
+#define RECOVERY_READBACK_FIRST	AD74413_REG_CH_FUNC_SETUP0
+#define RECOVERY_READBACK_COUNT	(AD74413_REG_DIAG_ASSIGN - AD74413_REG_CH_FUNC_SETUP0 + 1)
+
+// наибольший пакет SPI_writeBatch
+#define BATCH_MAX_FRAMES				RECOVERY_MAX_FRAMES
+
+
 /*static*/ AD74413R_API APIDefinitions[MAX_SUPPORTED_AD74413R];
 
+// миллисекундная метка времени, наращивается из AD74413R_tick1ms
+static volatile uint32_t msTicks = 0;
 
-static inline AD74413R_API *getPtrFromRef(uint8_t API_ref);
+// чип, расчёты которого выполняются во время ожидания CS следующего чипа
+static AD74413R_API *pCalcPending = 0;
 
-static inline uint8_t		BA_getAddr(uint8_t *BA_array);
-static inline uint16_t	BA_getData(uint8_t *BA_array);
-static inline uint8_t		BA_getCRC(uint8_t *BA_array);
+
+static inline AD74413R_API *getPtrFromRef(uint8_t API_ref);
 
 static void initialiseAPI(AD74413R_API	*pAPI,
 										uint8_t							API_ref,
@@ -21,23 +53,32 @@ static void initialiseAPI(AD74413R_API	*pAPI,
 										MDR_PORT_TypeDef*		adcRdyPORTx,
 										uint32_t						adcRdyPORT_Pin);
 
-static bool BA_CRC(uint8_t *pFrameBA, bool bUpdate);
-static bool BA_validate(uint8_t *pFrameBA, uint8_t nRegAdr);
-static void BA_create(uint8_t *pFrameBA, uint8_t nRegAdr, uint16_t nData);
-static bool BA_extract(uint8_t *pFrameBA,	uint8_t nRegAdr,
-											uint16_t	spiMsbFramePart,	uint16_t	spiLsbFramePart);
+static void runPendingCalc(void);
+static void waitCsSettle(void);
+static void waitUs(uint16_t us);
 
 static inline void SPI_setCS(AD74413R_API	*pAPI);
 static inline void SPI_resetCS(AD74413R_API	*pAPI);
 
+static AD74413R_RESULT	SPI_transferFrame32(AD74413R_API		*pAPI,
+																						const uint16_t	*pTxWords,
+																						uint16_t				*pRxWords);
+
 static AD74413R_RESULT	SPI_writeFrame32(AD74413R_API	*pAPI,
 																uint8_t nRegAdr, uint16_t nData,
 																	bool	validate);
-static AD74413R_RESULT	SPI_writeNOP(AD74413R_API *pAPI);
 static AD74413R_RESULT	SPI_readFrame32(AD74413R_API	*pAPI,
 																							uint8_t	nRegAdr);
 
-static void	SPI_softwareReset(AD74413R_API	*pAPI);
+static AD74413R_RESULT	SPI_readBurst32(AD74413R_API	*pAPI,
+																				uint8_t				nFirstRegAdr,
+																				uint8_t				count,
+																				uint16_t			*pData);
+static AD74413R_RESULT	SPI_writeBatch(AD74413R_API			*pAPI,
+																			const tRegister	*pRegs,
+																			uint8_t					count);
+static AD74413R_RESULT	SPI_softwareReset(AD74413R_API	*pAPI);
+static bool probeChip(AD74413R_API *pAPI);
 
 static void setChState(AD74413R_API	*pAPI,
 														uint8_t		chId,
@@ -49,28 +90,115 @@ static void setDiagState(AD74413R_API	*pAPI,
 static uint16_t calcDacCodeForVoltage(float	Volt);
 static uint16_t calcDacCodeForCurrent(float	mA);
 
+static AD74413R_RESULT writeOutputConfig(AD74413R_API	*pAPI,
+																				uint8_t				chId,
+																				uint16_t			outputConfig);
+static uint16_t selectSlew(uint16_t	delta,
+													uint32_t	rampMs);
+static void applyRamps(AD74413R_API *pAPI);
+static void calcRegulator(AD74413R_API *pAPI, uint8_t chId);
+static void applyRegulators(AD74413R_API *pAPI);
+
+static AD74413R_RESULT triggerDacClear(AD74413R_API *pAPI);
+static void dispatchAlert(AD74413R_API *pAPI);
 static void checkAlert(AD74413R_API *pAPI);
+static AD74413R_RESULT checkRecovery(AD74413R_API *pAPI);
+static bool analyzeLiveStatus(AD74413R_API *pAPI);
+static uint8_t viErrPollMask(AD74413R_API *pAPI);
 static void checkAdcDiag(AD74413R_API *pAPI);
 
 static inline float calcCurrentInVoltageOutputMode(uint16_t	ADC_CODE,
 																											float	Vmin,
 																											float	Vrange);
 static inline float calcVoltageInCurrentOutputMode(uint16_t	ADC_CODE,
+																											float	Vmin,
 																											float	Vrange);
 static inline float calcVoltageInVoltageInputMode(uint16_t	ADC_CODE,
 																										float		Vmin,
 																										float		Vrange);
 static inline float calcCurrentInCurrentInputMode(uint16_t	ADC_CODE,
+																										float		Vmin,
 																										float		Vrange);
 static inline float calcResistanceInResMeasMode(uint16_t	ADC_CODE,
 																									float		wireRes);
+static float calcRtdTemperature(AD74413R_RTD_TYPE	rtdType,
+																float							resistance);
+static float getCjcTemperature(AD74413R_API *pAPI);
+static bool isDiagScheduled(AD74413R_API *pAPI, AD74413R_DIAGNOSTIC_MODE diagSrc);
+static void scheduleCjc(AD74413R_API *pAPI);
+static bool isProfileCjcScheduled(const tChProfile *pProfile);
+static float calcTcTemperature(AD74413R_API	*pAPI,
+																AD74413R_TC_TYPE	tcType,
+																uint16_t			ADC_CODE);
 
+static void getAdcRange(uint16_t	adcConfig,
+												float			*pVmin,
+												float			*pVrange);
+static uint8_t nextSeqMask(AD74413R_API *pAPI);
+static void startSequence(AD74413R_API *pAPI, uint8_t seqMask);
+static void restartConversions(AD74413R_API *pAPI);
+static void setSeqPeriod(AD74413R_API *pAPI, uint8_t slot, uint8_t period);
+static inline uint16_t elapsedUs(uint16_t *pLastTick);
+static AD74413R_RESULT waitAdcReady(AD74413R_API *pAPI, uint32_t *pLatencyUs);
+static AD74413R_RESULT writeAdcConfig(AD74413R_API	*pAPI,
+																			uint8_t				chId,
+																			uint16_t			adcConfig);
+static void storeAdcConfig(AD74413R_API *pAPI, uint8_t chId, uint16_t chipConfig);
+static void syncAdcConfig(AD74413R_API *pAPI, uint8_t chId);
+static void checkAutoRange(AD74413R_API *pAPI, uint8_t chId);
+static void applyAutoRange(AD74413R_API *pAPI);
+
+static inline void sortPair(uint16_t *pA, uint16_t *pB);
+static inline uint16_t median3(uint16_t *pCodes);
+static inline uint16_t median5(uint16_t *pCodes);
+static uint16_t filterSpike(tSpikeFilter *pFilter, uint16_t adcCode);
+
+static float calcChValue(AD74413R_API	*pAPI,
+													uint8_t				chId,
+													uint16_t			adcCode,
+													uint16_t			adcConfig);
+static float getChVal(AD74413R_API *pAPI, uint8_t chId);
+static void checkSense(AD74413R_API *pAPI, uint8_t chId);
+static void dropUnscheduledSense(AD74413R_API *pAPI);
+static void checkFault(AD74413R_API *pAPI, uint8_t chId, uint16_t adcCode);
+static void resetFault(tChFault *pFault, AD74413R_CHANNEL_MODE chMode);
 static void calcAdcRes(AD74413R_API *pAPI);
 
+static inline bool isDinMode(AD74413R_CHANNEL_MODE chMode);
+static void checkDinCounters(AD74413R_API *pAPI);
+static AD74413R_RESULT readDinSnapshot(AD74413R_API *pAPI);
+
 static float calcTemperature(uint16_t	DIAG_CODE);
+static float calcDiagValue(AD74413R_DIAGNOSTIC_MODE	diagMode,
+														uint16_t									DIAG_CODE);
 
+static float getDiagVal(AD74413R_API *pAPI, uint8_t diagId);
 static void calcDiagRes(AD74413R_API *pAPI);
 
+static uint16_t chFuncSetup(AD74413R_CHANNEL_MODE chMode);
+static inline bool isAdcMode(AD74413R_CHANNEL_MODE chMode);
+static bool chDinConfig(AD74413R_API						*pAPI,
+												uint8_t									chId,
+												AD74413R_CHANNEL_MODE		chMode,
+												uint16_t								*pDinConfig);
+static void resetChState(AD74413R_API						*pAPI,
+													uint8_t									chId,
+													AD74413R_CHANNEL_MODE		chMode);
+static void applyChMode(AD74413R_API					*pAPI,
+												uint8_t								chId,
+												AD74413R_CHANNEL_MODE	chMode);
+static void applyDiagMode(AD74413R_API							*pAPI,
+													uint8_t										diagId,
+													AD74413R_DIAGNOSTIC_MODE	diagMode);
+static AD74413R_RESULT writeDiagAssign(AD74413R_API	*pAPI,
+																			uint16_t			diagAssign);
+static AD74413R_DIAGNOSTIC_MODE nextDiagSource(AD74413R_API *pAPI);
+static void applyDiagRotation(AD74413R_API *pAPI);
+static uint8_t buildChipConfig(AD74413R_API *pAPI, tRegister *pRegs);
+static inline uint8_t readbackIdx(uint8_t regAdr);
+static AD74413R_RESULT readChipConfig(AD74413R_API *pAPI, uint16_t *pReadback);
+static AD74413R_RESULT restoreChipConfig(AD74413R_API *pAPI);
+
 
 static inline AD74413R_API *getPtrFromRef(uint8_t API_ref)
 {
@@ -78,22 +206,6 @@ static inline AD74413R_API *getPtrFromRef(uint8_t API_ref)
 }
 
 
-static inline uint8_t BA_getAddr(uint8_t *BA_array)
-{
-	return (uint8_t)(*(BA_array+0) & 0x7F);
-}
-
-static inline uint16_t BA_getData(uint8_t *BA_array)
-{
-	return (uint16_t)((((uint16_t)*(BA_array+1)) << 8) | (uint16_t)*(BA_array+2));
-}
-
-static inline uint8_t BA_getCRC(uint8_t *BA_array)
-{
-	return (uint8_t)*(BA_array+3);
-}
-
-
 //
 static void initialiseAPI(AD74413R_API	*pAPI,
 										uint8_t							API_ref,
@@ -125,135 +237,44 @@ static void initialiseAPI(AD74413R_API	*pAPI,
 }
 
 
-/*!
- * @brief Calculate the CRC of a 4 bytes frame, and either update it or check it.
-
-               To verify that data has been received
-               correctly in noisy environ-ments, the
-               ad74413R has a CRC implemented in the
-               SPI interface.  This CRC is based on an
-               8 bit cyclic redundancy check (CRC-8).
-               The device controlling the ad74413R
-               generates an 8-bit frame check sequence
-               using the following polynomial:
-               C(x) = x8 + x2 + x1 + 1
-               This sequence is added to the end of
-               the data-word, and 32 bits are sent
-               to the ad74413R before taking SYNC high.
-
-               E.g. 0x41002E has a CRC of 0x27
-
-               E.g. 0xAEA020 has a CRC of 0x9C
-   @param[in]   pFrameBA : Array of bytes to check/update.
-   @param[in]   bUpdate  : True if to be updated, False if just to be checked.
-
-  @return     False, if CRC is not valid after call, otherwise True
- */
-static bool BA_CRC(uint8_t *pFrameBA, bool bUpdate)
+// расчёт результатов отложенного чипа (без обращений к SPI)
+static void runPendingCalc(void)
 {
-	uint32_t CRCcode = 0x107;
-	uint32_t i = 31;
-	uint32_t DataOUT = (((uint32_t)pFrameBA[0]) << 24) |
-										(((uint32_t)pFrameBA[1]) << 16) | (((uint32_t)pFrameBA[2]) << 8);
+	AD74413R_API	*pAPI	=	pCalcPending;
 	
-	while (i >= 8)
+	if(pAPI)
 	{
-			if ((DataOUT & (1 << i)) != 0)
-			{
-					DataOUT ^= (CRCcode << (i - 8));
-			}
-			i--;
+		pCalcPending = 0;
+		calcAdcRes(pAPI);
+		calcDiagRes(pAPI);
 	}
+}
+
+
+// ожидание установки CS, время ожидания используется для отложенных расчётов
+static void waitCsSettle(void)
+{
+	uint16_t	startTick	=	TIMEOUT_TIMER->CNT;
+	
+	runPendingCalc();
 	
-	if(bUpdate)
+	while(((uint16_t)((uint16_t)TIMEOUT_TIMER->CNT - startTick)) < AD74413R_CS_SETTLE_TICKS)
 	{
-			pFrameBA[3] = (uint8_t)DataOUT;
-			return true;
+		;
 	}
-	else
-	{
-			if(pFrameBA[3] == (uint8_t)DataOUT)
-					return true;
-			else
-					return false;
-	}
-}
-
-/**
- *  \brief Check that the response word via that we received is valid
- *
- *  \param [in] nAdr         The address of the register than is expected here
- *  \param [in] pFrameBA     The 4 byte array as received from the device
- *
- *  \return Return_Description
- *
- *  \details Details
- */
-static bool BA_validate(uint8_t *pFrameBA, uint8_t nRegAdr)
-{
-	bool bValid = true;
-	
-	// SPI_RD_RET_INFO = 0 !!
-	// D31        1
-	if ((pFrameBA[0] & 0x80) == 0x00)
-			bValid = false;
-	// D30:D24    READBACK_ADDR[6:0]
-	if (BA_getAddr(pFrameBA) != (nRegAdr & 0x7F))
-			bValid = false;
-	
-	// D23:D8     READ DATA
-	//Result = (ResponseWord >> 8) & 0xFFFF;
-	// D0:D7      CRC
-	
-	if(!BA_CRC(pFrameBA, false))
-			bValid = false;
-	
-	return bValid;
-}
-
-/*!
- * @brief       Construct an array of bytes which are in the correct order for
-                an SPI transaction representing a regster write
- *
-   @param[in]   nAdr : Specifies the address of the register to write to.
-   @param[in]   nData: Specifies the data to write to the register.
-   @param[out]  pBytesTxOrdered:
-  *
-   @return
- */
-static void BA_create(uint8_t *pFrameBA, uint8_t nRegAdr, uint16_t nData)
-{
-	// D31    : Reserved (will use 0)
-	// D30:D24: Address.
-	pFrameBA[0] = nRegAdr;
-	// D23:D8 : Data (Big endian)
-	pFrameBA[1] = (nData >> 8) & 0xFF;
-	pFrameBA[2] = (nData >> 0) & 0xFF;
-	// D7 :D0 : CRC
-	
-	/* Update the CRC of the Frame */
-	(void)BA_CRC(pFrameBA, true);
 }
 
-//
-static bool BA_extract(uint8_t *pFrameBA,	uint8_t nRegAdr,
-											uint16_t	spiMsbFramePart,	uint16_t	spiLsbFramePart)
+
+// ожидание не меньше us мкс по TIMEOUT_TIMER, неполный первый тик не засчитывается
+static void waitUs(uint16_t us)
 {
-	bool bValid = true;
-	
-	// D31    : Reserved (will use 0)
-	// D30:D24: Address.
-	pFrameBA[0] = (uint8_t)((spiMsbFramePart >> 8) & 0xFF);
-	// D23:D8 : Data (Big endian)
-	pFrameBA[1] = (uint8_t)((spiMsbFramePart >> 0) & 0xFF);
-	pFrameBA[2] = (uint8_t)((spiLsbFramePart >> 8) & 0xFF);
-	// D7 :D0 : CRC
-	pFrameBA[3] = (uint8_t)((spiLsbFramePart >> 0) & 0xFF);
+	uint16_t	startTick	=	TIMEOUT_TIMER->CNT;
+	uint32_t	ticks			=	(uint32_t)us * AD74413R_TIMER_TICKS_PER_US + 1;
 	
-	/* check CRC */
-	bValid = BA_validate(pFrameBA, nRegAdr);
-	
-	return bValid;
+	while(((uint16_t)((uint16_t)TIMEOUT_TIMER->CNT - startTick)) < ticks)
+	{
+		;
+	}
 }
 
 
@@ -263,7 +284,7 @@ static inline void SPI_setCS(AD74413R_API	*pAPI)
 	//PORT_SetBits(pAPI->spiInfo.csPORTx, pAPI->spiInfo.csPORT_Pin);
 	MCP23S17_portSetBits(pAPI->spiInfo.csPORTx, pAPI->spiInfo.csPORT_Pin);
 	MCP23S17_portCommit(pAPI->spiInfo.csPORTx);
-	delay_ms(MDR_TIMER2, 1);
+	waitCsSettle();
 }
 
 //
@@ -272,26 +293,17 @@ static inline void SPI_resetCS(AD74413R_API	*pAPI)
 	//PORT_ResetBits(pAPI->spiInfo.csPORTx, pAPI->spiInfo.csPORT_Pin);
 	MCP23S17_portResetBits(pAPI->spiInfo.csPORTx, pAPI->spiInfo.csPORT_Pin);
 	MCP23S17_portCommit(pAPI->spiInfo.csPORTx);
-	delay_ms(MDR_TIMER2, 1);
+	waitCsSettle();
 }
 
 
-// запись кадра в регистр
-static AD74413R_RESULT	SPI_writeFrame32(AD74413R_API	*pAPI,
-															uint8_t nRegAdr, uint16_t nData,
-															bool		validate)
-{	
-	AD74413R_RESULT	result					=	AD74413R_RESULT_OK;
-	uint16_t				readBackData		= 0;
-	uint16_t				spiMsbFramePart =	0;
-	uint16_t				spiLsbFramePart =	0;
-	
-	BA_create(pAPI->spiInfo.frameBA, nRegAdr, nData);
-	
-	spiMsbFramePart	=	((uint32_t)(pAPI->spiInfo.frameBA[0])) << 8
-										|((uint32_t)(pAPI->spiInfo.frameBA[1])) << 0;
-	spiLsbFramePart	=	((uint32_t)(pAPI->spiInfo.frameBA[2])) << 8
-										|((uint32_t)(pAPI->spiInfo.frameBA[3])) << 0;
+// обмен одним 32-битным кадром
+static AD74413R_RESULT	SPI_transferFrame32(AD74413R_API		*pAPI,
+																						const uint16_t	*pTxWords,
+																						uint16_t				*pRxWords)
+{
+	AD74413R_RESULT	result		=	AD74413R_RESULT_OK;
+	uint16_t				startTick	=	0;
 	
 	SPI_resetCS(pAPI);
 	
@@ -301,23 +313,62 @@ static AD74413R_RESULT	SPI_writeFrame32(AD74413R_API	*pAPI,
 	if(SPIx_getFlagStatus(pAPI->spiInfo.SSPx, SSP_FLAG_TFE, true) != SPI_RESULT_OK)
 		result = AD74413R_RESULT_SPI_FAILURE;
 	
+	// очистка приёмника от данных предыдущих кадров (в т.ч. кадров управления CS)
+	while(SSP_GetFlagStatus(pAPI->spiInfo.SSPx, SSP_FLAG_RNE))
+	{
+		(void)SSP_ReceiveData(pAPI->spiInfo.SSPx);
+	}
+	
 	// передача MSB и LSB
-	SSP_SendData(pAPI->spiInfo.SSPx, spiMsbFramePart);
-	SSP_SendData(pAPI->spiInfo.SSPx, spiLsbFramePart);
+	SSP_SendData(pAPI->spiInfo.SSPx, pTxWords[0]);
+	SSP_SendData(pAPI->spiInfo.SSPx, pTxWords[1]);
 		
 	// ожидание завершения передачи
 	if(SPIx_getFlagStatus(pAPI->spiInfo.SSPx, SSP_FLAG_BSY, false) != SPI_RESULT_OK)
 		result = AD74413R_RESULT_SPI_FAILURE;
+	
+	// приём MSB и LSB ответа до передачи кадра управления CS
+	startTick = TIMEOUT_TIMER->CNT;
+	
+	for(uint8_t i = 0; (i < AD74413R_FRAME_WORDS) && (result == AD74413R_RESULT_OK); i++)
+	{
+		while(!SSP_GetFlagStatus(pAPI->spiInfo.SSPx, SSP_FLAG_RNE))
+		{
+			if(((uint16_t)((uint16_t)TIMEOUT_TIMER->CNT - startTick)) > TIMEOUT_TICKS)
+			{
+				result = AD74413R_RESULT_SPI_FAILURE;
+				break;
+			}
+		}
+		if(result == AD74413R_RESULT_OK)
+			pRxWords[i] = SSP_ReceiveData(pAPI->spiInfo.SSPx);
+	}
 		
 	SPI_setCS(pAPI);
+	
+	return result;
+}
+
+
+// запись кадра в регистр
+static AD74413R_RESULT	SPI_writeFrame32(AD74413R_API	*pAPI,
+															uint8_t nRegAdr, uint16_t nData,
+															bool		validate)
+{	
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	uint16_t				txWords[AD74413R_FRAME_WORDS];
+	uint16_t				rxWords[AD74413R_FRAME_WORDS];
+	
+	AD74413R_frameEncode(nRegAdr, nData, txWords);
+	
+	result = SPI_transferFrame32(pAPI, txWords, rxWords);
 		
 	if(validate && (result == AD74413R_RESULT_OK))
 	{
 		result = SPI_readFrame32(pAPI, nRegAdr);
 		if(result == AD74413R_RESULT_OK)
 		{
-			readBackData = BA_getData(pAPI->spiInfo.frameBA);
-			if(readBackData != nData)
+			if(pAPI->spiInfo.rxData != nData)
 				result = AD74413R_RESULT_REG_WRONG_DATA_IS_WRITTEN;
 		}
 	}
@@ -325,66 +376,135 @@ static AD74413R_RESULT	SPI_writeFrame32(AD74413R_API	*pAPI,
 	return	result;
 }
 
-//
-static AD74413R_RESULT SPI_writeNOP(AD74413R_API *pAPI)
-{
-	return SPI_writeFrame32(pAPI, AD74413_REG_NOP, 0x0000, false);
-}
-
 // чтение регистра
 static AD74413R_RESULT SPI_readFrame32(AD74413R_API	*pAPI,
 																				uint8_t	nRegAdr)
 {
-	AD74413R_RESULT	result					=	AD74413R_RESULT_OK;
-	bool						bValid					=	true;
-	uint16_t				spiMsbFramePart =	0;
-	uint16_t				spiLsbFramePart =	0;
-	uint16_t				startTick				=	0;
-	
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	uint16_t				txWords[AD74413R_FRAME_WORDS];
+	uint16_t				rxWords[AD74413R_FRAME_WORDS];
 	
 	result = SPI_writeFrame32(pAPI, AD74413_REG_READ_SELECT, ((uint16_t)nRegAdr) | BITM_READ_SELECT_AUTO_RD_EN, false);
-	result = SPI_writeNOP(pAPI);
 	
-	startTick = TIMEOUT_TIMER->CNT;
+	if(result == AD74413R_RESULT_OK)
+	{
+		// данные выбранного регистра приходят в ответ на NOP
+		AD74413R_frameEncode(AD74413_REG_NOP, 0x0000, txWords);
+		result = SPI_transferFrame32(pAPI, txWords, rxWords);
+	}
 	
-	// флаг освобождения буфера передатчика
-	while(SSP_GetFlagStatus(pAPI->spiInfo.SSPx, SSP_FLAG_RNE))
+	if(result == AD74413R_RESULT_OK)
+	{
+		if(!AD74413R_frameDecode(rxWords, nRegAdr, &pAPI->spiInfo.rxData))
+			result = AD74413R_RESULT_CRC_FAILURE;
+	}
+	
+	return result;
+}
+
+
+// чтение подряд идущих регистров: после выбора первого регистра с AUTO_RD_EN
+// каждый NOP возвращает следующий, count регистров за count+1 кадр
+static AD74413R_RESULT	SPI_readBurst32(AD74413R_API	*pAPI,
+																				uint8_t				nFirstRegAdr,
+																				uint8_t				count,
+																				uint16_t			*pData)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	uint16_t				txWords[AD74413R_FRAME_WORDS];
+	uint16_t				rxWords[AD74413R_FRAME_WORDS];
+	
+	result = SPI_writeFrame32(pAPI, AD74413_REG_READ_SELECT, ((uint16_t)nFirstRegAdr) | BITM_READ_SELECT_AUTO_RD_EN, false);
+	
+	AD74413R_frameEncode(AD74413_REG_NOP, 0x0000, txWords);
+	
+	for(uint8_t i = 0; (i < count) && (result == AD74413R_RESULT_OK); i++)
 	{
-		spiMsbFramePart = SSP_ReceiveData(pAPI->spiInfo.SSPx);
-		spiLsbFramePart = SSP_ReceiveData(pAPI->spiInfo.SSPx);
-		if(((uint16_t)((uint16_t)TIMEOUT_TIMER->CNT - startTick)) > TIMEOUT_TICKS)
+		result = SPI_transferFrame32(pAPI, txWords, rxWords);
+		
+		if(result == AD74413R_RESULT_OK)
 		{
-			result = AD74413R_RESULT_SPI_FAILURE;
-			break;
+			if(!AD74413R_frameDecode(rxWords, nFirstRegAdr+i, &pData[i]))
+				result = AD74413R_RESULT_CRC_FAILURE;
 		}
 	}
-		
-	if(result != AD74413R_RESULT_OK)
+	
+	return result;
+}
+
+
+// запись последовательности регистров без проверки чтением: кадры
+// формируются заранее, между передачами остаётся только переключение CS
+static AD74413R_RESULT	SPI_writeBatch(AD74413R_API			*pAPI,
+																			const tRegister	*pRegs,
+																			uint8_t					count)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	uint16_t				txWords[BATCH_MAX_FRAMES * AD74413R_FRAME_WORDS];
+	uint16_t				rxWords[AD74413R_FRAME_WORDS];
+	
+	if(count > BATCH_MAX_FRAMES)
+		return ad74413_RESULT_NO_RESOURCES;
+	
+	(void)AD74413R_frameEncodeBatch(pRegs, count, txWords);
+	
+	for(uint8_t i = 0; (i < count) && (result == AD74413R_RESULT_OK); i++)
 	{
-		return result;
+		result = SPI_transferFrame32(pAPI, &txWords[i * AD74413R_FRAME_WORDS], rxWords);
 	}
-	else
+	
+	return result;
+}
+
+
+// программный сброс ключами CMD_KEY с ожиданием его завершения по RESET_OCCURRED
+static AD74413R_RESULT	SPI_softwareReset(AD74413R_API	*pAPI)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_FAILURE;
+	
+	// защёлкнутые флаги (в т.ч. RESET_OCCURRED включения питания) сбрасываются,
+	// чтобы RESET_OCCURRED мог появиться только от этого сброса
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_ALERT_STATUS, 0xFFFF, false);
+	
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_CMD_KEY, ENUM_CMD_KEY_SW_RST_KEY1, false);
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_CMD_KEY, ENUM_CMD_KEY_SW_RST_KEY2, false);
+	
+	// пока чип в сбросе кадры ответа не проходят проверку CRC
+	for(uint8_t attempt = 0; attempt < AD74413R_RESET_POLL_ATTEMPTS; attempt++)
 	{
-		bValid = BA_extract(pAPI->spiInfo.frameBA, nRegAdr, spiMsbFramePart, spiLsbFramePart);
-		
-		if(bValid)
+		if((SPI_readFrame32(pAPI, AD74413_REG_ALERT_STATUS) == AD74413R_RESULT_OK)
+				&& (pAPI->spiInfo.rxData & BITM_ALERT_STATUS_RESET_OCCURRED))
 		{
+			(void)SPI_writeFrame32(pAPI, AD74413_REG_ALERT_STATUS,
+														pAPI->spiInfo.rxData,
+														false);
 			result = AD74413R_RESULT_OK;
-			return result;
-		}
-		else
-		{
-			result = AD74413R_RESULT_CRC_FAILURE;
-			return result;
+			break;
 		}
 	}
+	
+	return result;
 }
 
 
-//
-static void	SPI_softwareReset(AD74413R_API	*pAPI)
+// проверка наличия чипа: SILICON_REV читается с верными CRC и адресом,
+// SCRATCH записывается и читается прямым и инверсным шаблоном, что исключает
+// линию MISO, залипшую в 0 или 1
+static bool probeChip(AD74413R_API *pAPI)
 {
-	;
+	if(SPI_readFrame32(pAPI, AD74413_REG_SILICON_REV) != AD74413R_RESULT_OK)
+		return false;
+	if((pAPI->spiInfo.rxData & BITM_SILICON_REV_SILICON_REV_ID) == 0)
+		return false;
+	
+	if(SPI_writeFrame32(pAPI, AD74413_REG_SCRATCH, AD74413R_PROBE_PATTERN, true) != AD74413R_RESULT_OK)
+		return false;
+	if(SPI_writeFrame32(pAPI, AD74413_REG_SCRATCH, (uint16_t)~AD74413R_PROBE_PATTERN, true) != AD74413R_RESULT_OK)
+		return false;
+	
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_SCRATCH, AD74413_REG_SCRATCH_RESET, false);
+	
+	return true;
 }
 
 
@@ -438,647 +558,3607 @@ static uint16_t calcDacCodeForCurrent(float	mA)
 }
 
 
-//
-static void checkAlert(AD74413R_API *pAPI)
+// запись OUTPUT_CONFIG только при изменении
+static AD74413R_RESULT writeOutputConfig(AD74413R_API	*pAPI,
+																				uint8_t				chId,
+																				uint16_t			outputConfig)
 {
-	uint16_t data = 0;
-
-	(void)SPI_readFrame32(pAPI, AD74413_REG_ALERT_STATUS);
-	data = BA_getData(pAPI->spiInfo.frameBA);
-	
-	*((uint16_t*)(&pAPI->alertInfo)) = data;
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
 	
+	if(pAPI->chInfo[chId].outputConfig != outputConfig)
+	{
+		result = SPI_writeFrame32(pAPI, AD74413_REG_OUTPUT_CONFIG0+chId,
+															outputConfig,
+															true);
+		if(result == AD74413R_RESULT_OK)
+			pAPI->chInfo[chId].outputConfig = outputConfig;
+	}
 	
-	(void)SPI_writeFrame32(pAPI, AD74413_REG_ALERT_STATUS,
-												0xFFFF,
-												false);
+	return result;
 }
 
-//
-static void checkAdcDiag(AD74413R_API *pAPI)
+
+// шаги и частоты встроенного линейного нарастания ЦАП
+static const uint16_t	slewStep[]			=	{	64,	120,	500,	1820	};
+static const uint16_t	slewStepCfg[]		=	{	ENUM_OUTPUT_CONFIG_STEP_64,
+																				ENUM_OUTPUT_CONFIG_STEP_120,
+																				ENUM_OUTPUT_CONFIG_STEP_500,
+																				ENUM_OUTPUT_CONFIG_STEP_1820	};
+static const uint32_t	slewRate[]			=	{	4000,	64000,	150000,	240000	};
+static const uint16_t	slewRateCfg[]		=	{	ENUM_OUTPUT_CONFIG_RATE_4KHZ,
+																				ENUM_OUTPUT_CONFIG_RATE_64KHZ,
+																				ENUM_OUTPUT_CONFIG_RATE_150KHZ,
+																				ENUM_OUTPUT_CONFIG_RATE_240KHZ	};
+
+// подбор шага и частоты нарастания, время которых ближе всего к заданному;
+// 0 - встроенное нарастание не укладывается в допуск AD74413R_SLEW_TOLERANCE
+static uint16_t selectSlew(uint16_t	delta,
+													uint32_t	rampMs)
 {
-	uint16_t data = 0;
+	uint16_t	slewConfig	=	0;
+	uint32_t	reqUs				=	rampMs * 1000;
+	uint32_t	bestErrUs		=	0xFFFFFFFF;
+	uint32_t	steps				=	0;
+	uint32_t	rampUs			=	0;
+	uint32_t	errUs				=	0;
 	
-	if(pAPI->chUsage != 0)
+	for(uint8_t stepId = 0; stepId < sizeof(slewStep)/sizeof(slewStep[0]); stepId++)
 	{
-		//while(PORT_ReadInputDataBit(pAPI->pinsInfo.adcRdyPORTx, pAPI->pinsInfo.adcRdyPORT_Pin))	{;}
-			
-		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
-		{
-			if(pAPI->chUsage & (1 << chId))
-			{
-				(void)SPI_readFrame32(pAPI, AD74413_REG_ADC_RESULT0+chId);
-				data = BA_getData(pAPI->spiInfo.frameBA);
-				
-				pAPI->chInfo[chId].adcCode = data;
-			}
-		}
-		for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+		steps = (delta + slewStep[stepId] - 1) / slewStep[stepId];
+		
+		for(uint8_t rateId = 0; rateId < sizeof(slewRate)/sizeof(slewRate[0]); rateId++)
 		{
-			if(pAPI->chUsage & (1 << diagId+4))
+			rampUs	=	(uint32_t)(((uint64_t)steps * 1000000) / slewRate[rateId]);
+			errUs		=	(rampUs > reqUs)?(rampUs - reqUs):(reqUs - rampUs);
+			
+			if(errUs < bestErrUs)
 			{
-				(void)SPI_readFrame32(pAPI, AD74413_REG_DIAG_RESULT0+diagId);
-				data = BA_getData(pAPI->spiInfo.frameBA);
-				
-				pAPI->diagInfo[diagId].diagCode = data;
+				bestErrUs		=	errUs;
+				slewConfig	=	ENUM_OUTPUT_CONFIG_SLEW_LINEAR
+											|slewStepCfg[stepId]
+											|slewRateCfg[rateId];
 			}
 		}
 	}
+	
+	if(bestErrUs > (uint32_t)(reqUs * AD74413R_SLEW_TOLERANCE))
+		slewConfig = 0;
+	
+	return slewConfig;
 }
 
 
-//
-static inline  float calcCurrentInVoltageOutputMode(uint16_t	ADC_CODE,
-																										float			Vmin,
-																										float			Vrange)
+// программное нарастание ЦАП для профилей, недоступных встроенному нарастанию
+static void applyRamps(AD74413R_API *pAPI)
 {
-	float current = 0.0f;
+	uint32_t	now				=	msTicks;
+	uint32_t	elapsed		=	0;
+	uint16_t	dacCode		=	0;
+	int32_t		span			=	0;
+	tDacRamp	*pRamp;
 	
-	current = ((Vmin + ((ADC_CODE/ADC_DIGIT) * Vrange)) / R_SENSE) * 1000.0f;
-	
-	return current;
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		pRamp = &pAPI->chInfo[chId].ramp;
+		
+		if(!pRamp->active || ((now - pRamp->lastMs) < AD74413R_RAMP_PERIOD_MS))
+			continue;
+		
+		elapsed = now - pRamp->startMs;
+		if(elapsed >= pRamp->durationMs)
+		{
+			dacCode = pRamp->targetCode;
+		}
+		else
+		{
+			span		=	(int32_t)pRamp->targetCode - (int32_t)pRamp->startCode;
+			dacCode	=	(uint16_t)((int32_t)pRamp->startCode
+													+ (int32_t)(((int64_t)span * elapsed) / pRamp->durationMs));
+		}
+		
+		// промежуточные точки не проверяются, конечная - с проверкой записи
+		if(SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+												dacCode,
+												(dacCode == pRamp->targetCode)) == AD74413R_RESULT_OK)
+		{
+			pAPI->chInfo[chId].dacCode = dacCode;
+			if(dacCode == pRamp->targetCode)
+				pRamp->active = false;
+		}
+		pRamp->lastMs = now;
+	}
 }
 
-//
-static inline float calcVoltageInCurrentOutputMode(uint16_t	ADC_CODE,
-																									float			Vrange)
+
+// ПИ-регулятор выхода по измеренному в этом же цикле значению:
+// ток нагрузки для выхода напряжения, напряжение на клеммах для выхода тока;
+// kp - кодов ЦАП на единицу ошибки, ki - кодов ЦАП на единицу ошибки за секунду
+static void calcRegulator(AD74413R_API *pAPI, uint8_t chId)
 {
-	float voltage = 0.0f;
+	tPiCtrl		*pPi			=	&pAPI->chInfo[chId].piCtrl;
+	uint32_t	now				=	msTicks;
+	float			dt				=	0.0f;
+	float			err				=	0.0f;
+	float			integ			=	0.0f;
+	float			out				=	0.0f;
+	int32_t		dacCode		=	0;
+	int32_t		prevCode	=	pAPI->chInfo[chId].dacCode;
 	
-	voltage = (ADC_CODE/ADC_DIGIT) * Vrange;
+	if(!pPi->enabled)
+		return;
 	
-	return voltage;
-}
-
-//
-static inline float calcVoltageInVoltageInputMode(uint16_t	ADC_CODE,
-																										float		Vmin,
-																										float		Vrange)
-{
-	float voltage = 0.0f;
+	dt					=	(now != pPi->lastMs)?((now - pPi->lastMs) / 1000.0f):0.001f;
+	pPi->lastMs	=	now;
 	
-	voltage = Vmin + (ADC_CODE/ADC_DIGIT) * Vrange;
+	err		=	pPi->setpoint - getChVal(pAPI, chId);
+	integ	=	pPi->integ + pPi->ki * err * dt;
+	out		=	pPi->kp * err + integ;
 	
-	return voltage;
-}
-
-//
-static inline float calcCurrentInCurrentInputMode(uint16_t	ADC_CODE,
-																										float		Vrange)
-{
-	float current = 0.0f;
+	// интегратор не накапливается, пока выход упирается в границу ЦАП (anti-windup)
+	if(out > DAC_CODE_MAX)
+	{
+		out = DAC_CODE_MAX;
+		if(err < 0.0f)
+			pPi->integ = integ;
+	}
+	else if(out < 0.0f)
+	{
+		out = 0.0f;
+		if(err > 0.0f)
+			pPi->integ = integ;
+	}
+	else
+	{
+		pPi->integ = integ;
+	}
 	
-	current = (((ADC_CODE/ADC_DIGIT) * Vrange) / R_SENSE) * 1000;
+	dacCode = (int32_t)(out + 0.5f);
 	
-	return current;
-}
-
-//
-static inline float calcResistanceInResMeasMode(uint16_t	ADC_CODE,
-																									float		wireRes)
-{
-	float resistance = 0.0f;
-		
-	resistance = (ADC_CODE*R_PULL_UP) / (ADC_DIGIT-ADC_CODE) - wireRes;
+	// ограничение скорости изменения выхода за цикл
+	if(pPi->maxStep != 0)
+	{
+		if(dacCode > prevCode + pPi->maxStep)
+			dacCode = prevCode + pPi->maxStep;
+		else if(dacCode < prevCode - pPi->maxStep)
+			dacCode = prevCode - pPi->maxStep;
+	}
 	
-	return resistance;
+	if(dacCode != prevCode)
+	{
+		pPi->dacReq					=	(uint16_t)dacCode;
+		pPi->updatePending	=	true;
+	}
 }
 
 
-/* ========================= ACCURACY TEST ============================== */
-
-
-static void clearMinMax(AD74413R_API *pAPI, uint8_t chId, float val)
+// запись рассчитанных регуляторами кодов ЦАП
+static void applyRegulators(AD74413R_API *pAPI)
 {
-	pAPI->chInfo[chId].accuracy.reload					=	false;
-	pAPI->chInfo[chId].accuracy.averageCounter	=	0;
-	pAPI->chInfo[chId].accuracy.averageVal			=	0;
-	pAPI->chInfo[chId].accuracy.minVal					=	val;
-	pAPI->chInfo[chId].accuracy.maxVal					=	0.0f;
-	pAPI->chInfo[chId].accuracy.nDeviationPercentage	=	0.0f;
-	pAPI->chInfo[chId].accuracy.pDeviationPercentage	=	0.0f;
-}
-
-static void checkMinMax(AD74413R_API *pAPI, uint8_t chId, float val)
-{		
-	if(pAPI->chInfo[chId].accuracy.reload == true)
+	tPiCtrl *pPi;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		pPi = &pAPI->chInfo[chId].piCtrl;
+		
+		if(pPi->enabled && pPi->updatePending)
+		{
+			pPi->updatePending = false;
+			
+			// запись без проверки: следующий цикл регулятора всё равно скорректирует выход
+			if(SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+													pPi->dacReq,
+													false) == AD74413R_RESULT_OK)
+			{
+				pAPI->chInfo[chId].dacCode = pPi->dacReq;
+			}
+		}
+	}
+}
+
+
+// перевод всех каналов с CLR_EN в безопасное состояние одним кадром CMD_KEY
+static AD74413R_RESULT triggerDacClear(AD74413R_API *pAPI)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	
+	result = SPI_writeFrame32(pAPI, AD74413_REG_CMD_KEY,
+														ENUM_CMD_KEY_DAC_CLR_KEY,
+														false);
+	if(result != AD74413R_RESULT_OK)
+		return result;
+	
+	pAPI->safeTriggerCount++;
+	
+	// выходы больше не следуют за рампами и регуляторами,
+	// кэш кода ЦАП соответствует фактическому выходу для восстановления после сброса
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(pAPI->chInfo[chId].outputConfig & BITM_OUTPUT_CONFIG_CLR_EN)
+		{
+			pAPI->chInfo[chId].ramp.active		=	false;
+			pAPI->chInfo[chId].piCtrl.enabled	=	false;
+			pAPI->chInfo[chId].dacCode				=	pAPI->chInfo[chId].clrCode;
+		}
+	}
+	
+	return result;
+}
+
+
+// вызов зарегистрированных обработчиков тревог
+static void dispatchAlert(AD74413R_API *pAPI)
+{
+	for(uint8_t i = 0; i < AD74413R_MAX_ALERT_HANDLERS; i++)
+	{
+		if(pAPI->alertCtrl.handlers[i])
+			pAPI->alertCtrl.handlers[i](pAPI->chipRef, pAPI->alertInfo);
+	}
+}
+
+// выходы, VI_ERR которых в режиме прерываний опрашивается через LIVE_STATUS:
+// пин ALERT молчит при замаскированном VI_ERR и не сообщает о пропадании
+// ошибки, поэтому опрос идёт только пока VI_ERR замаскирован или выставлен
+static uint8_t viErrPollMask(AD74413R_API *pAPI)
+{
+	uint8_t	pollMask	=	0;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if((pAPI->chInfo[chId].chMode != AD74413R_VOLTAGE_OUTPUT)
+				&& (pAPI->chInfo[chId].chMode != AD74413R_CURRENT_OUTPUT))
+		{
+			continue;
+		}
+		if((pAPI->alertCtrl.mask & (BITM_ALERT_MASK_VI_ERR_MASK_A << chId))
+				|| (pAPI->viErr & (1 << chId)))
+		{
+			pollMask |= (1 << chId);
+		}
+	}
+	
+	return pollMask;
+}
+
+//
+static void checkAlert(AD74413R_API *pAPI)
+{
+	uint16_t data = 0;
+	
+	// в режиме прерываний статус читается только после срабатывания пина ALERT;
+	// VI_ERR выходов, о которых пин не сообщит, берётся из LIVE_STATUS
+	// (если он не читается при опросе АЦП)
+	if(pAPI->alertCtrl.irqMode && !pAPI->alertCtrl.pending)
+	{
+		if(viErrPollMask(pAPI)
+				&& (pAPI->seqCtrl.onDemand || (!pAPI->seqCtrl.weighted && !pAPI->liveStatusGating)))
+			(void)analyzeLiveStatus(pAPI);
+		return;
+	}
+	
+	pAPI->alertCtrl.pending = false;
+	
+	if(SPI_readFrame32(pAPI, AD74413_REG_ALERT_STATUS) != AD74413R_RESULT_OK)
 	{
-		clearMinMax(pAPI, chId, val);
+		pAPI->alertCtrl.pending = pAPI->alertCtrl.irqMode;
+		return;
 	}
+	data = pAPI->spiInfo.rxData;
+	
+	*((uint16_t*)(&pAPI->alertInfo)) = data;
+	// ошибки выходов учитываются детектором неисправностей при расчёте каналов
+	pAPI->viErr = data & (BITM_ALERT_STATUS_VI_ERR_A|BITM_ALERT_STATUS_VI_ERR_B
+												|BITM_ALERT_STATUS_VI_ERR_C|BITM_ALERT_STATUS_VI_ERR_D);
 	
-	if(pAPI->chInfo[chId].accuracy.averageCounter < pAPI->chInfo[chId].accuracy.averageCounts)
+	if(data != 0)
 	{
-		pAPI->chInfo[chId].accuracy.averageCounter++;
+		// безопасное состояние выходов - первым кадром после чтения статуса
+		if(data & pAPI->safeTriggerMask)
+			(void)triggerDacClear(pAPI);
 		
-		pAPI->chInfo[chId].accuracy.averageVal += val;
+		// сброс только прочитанных флагов (W1C), новые флаги не теряются
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_ALERT_STATUS,
+													data,
+													false);
 		
-		if(pAPI->chInfo[chId].accuracy.averageCounter == pAPI->chInfo[chId].accuracy.averageCounts)
+		// сброс чипа или отброшенный им кадр: конфигурация восстанавливается
+		// в этом же проходе обработчика
+		if(data & BITM_ALERT_STATUS_RESET_OCCURRED)
 		{
-			pAPI->chInfo[chId].accuracy.averageVal = pAPI->chInfo[chId].accuracy.averageVal / pAPI->chInfo[chId].accuracy.averageCounts;
+			pAPI->recovery.resetCount++;
+			pAPI->recovery.resetPending = true;
+		}
+		if(data & BITM_ALERT_STATUS_SPI_CRC_ERR)
+		{
+			pAPI->recovery.crcErrCount++;
+			pAPI->recovery.checkPending = true;
 		}
 		
-		if(val < pAPI->chInfo[chId].accuracy.minVal)
-			pAPI->chInfo[chId].accuracy.minVal = val;
-		
-		if(val > pAPI->chInfo[chId].accuracy.maxVal)
-			pAPI->chInfo[chId].accuracy.maxVal = val;
+		dispatchAlert(pAPI);
 		
-		pAPI->chInfo[chId].accuracy.nDeviationPercentage	=	
-					(1 - pAPI->chInfo[chId].accuracy.minVal / pAPI->chInfo[chId].accuracy.actualVal) * 100.0f;
-		pAPI->chInfo[chId].accuracy.pDeviationPercentage	=	
-					(pAPI->chInfo[chId].accuracy.maxVal / pAPI->chInfo[chId].accuracy.actualVal - 1) * 100.0f;
+		// пин ALERT остаётся активным пока причина не устранена,
+		// поэтому статус перечитывается на следующем проходе
+		pAPI->alertCtrl.pending = pAPI->alertCtrl.irqMode;
 	}
 }
 
+// восстановление конфигурации по тревогам RESET_OCCURRED и SPI_CRC_ERR;
+// при неудаче повторяется на следующем проходе обработчика
+static AD74413R_RESULT checkRecovery(AD74413R_API *pAPI)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	
+	if(!pAPI->recovery.resetPending && !pAPI->recovery.checkPending)
+		return result;
+	
+	// после сброса счётчики DIN и диагностика чипа начинаются заново
+	if(pAPI->recovery.resetPending)
+	{
+		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+		{
+			pAPI->chInfo[chId].dinCnt.valid = false;
+		}
+		for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+		{
+			pAPI->diagInfo[diagId].settle = AD74413R_DIAG_SETTLE_SAMPLES;
+		}
+	}
+	
+	result = restoreChipConfig(pAPI);
+	
+	if(result == AD74413R_RESULT_OK)
+	{
+		pAPI->recovery.resetPending	=	false;
+		pAPI->recovery.checkPending	=	false;
+	}
+	else
+	{
+		pAPI->recovery.failCount++;
+	}
+	
+	return result;
+}
 
-/* ========================= ACCURACY TEST ============================== */
-
+// чтение и разбор LIVE_STATUS
+static bool analyzeLiveStatus(AD74413R_API *pAPI)
+{
+	if(SPI_readFrame32(pAPI, AD74413_REG_LIVE_STATUS) != AD74413R_RESULT_OK)
+		return false;
+	
+	memcpy(&pAPI->liveStatusInfo, &pAPI->spiInfo.rxData, sizeof(pAPI->liveStatusInfo));
+	// текущее состояние VI_ERR, в отличие от защёлкнутого в ALERT_STATUS
+	pAPI->viErr = pAPI->spiInfo.rxData & (BITM_LIVE_STATUS_VI_ERR_CURR_A|BITM_LIVE_STATUS_VI_ERR_CURR_B
+																				|BITM_LIVE_STATUS_VI_ERR_CURR_C|BITM_LIVE_STATUS_VI_ERR_CURR_D);
+	
+	return true;
+}
 
 //
-static void calcAdcRes(AD74413R_API *pAPI)
+static void checkAdcDiag(AD74413R_API *pAPI)
 {
-	AD74413R_CHANNEL_MODE chMode;
-	uint16_t	adcCode	=	0;
-	float			chVal		=	0.0f;
-	float			wireRes	=	0.0f;
+	uint16_t	data			= 0;
+	uint8_t		readMask	= pAPI->chUsage;
 	
-	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
+	if(pAPI->chUsage != 0)
 	{
-		chMode	=	pAPI->chInfo[chId].chMode;
-		adcCode	=	pAPI->chInfo[chId].adcCode;
+		//while(PORT_ReadInputDataBit(pAPI->pinsInfo.adcRdyPORTx, pAPI->pinsInfo.adcRdyPORT_Pin))	{;}
 		
-		switch(chMode)
+		// преобразования и чтения выполняются только в AD74413R_convertOnce
+		if(pAPI->seqCtrl.onDemand)
+			return;
+		
+		// одиночная последовательность: результаты только её слотов,
+		// АЦП простаивает до запуска следующей
+		if(pAPI->seqCtrl.weighted)
 		{
-			case AD74413R_HIGH_IMPEDANCE:
-				chVal = 0.0f;
-				break;
-			
-			case AD74413R_VOLTAGE_OUTPUT:
-				chVal = calcCurrentInVoltageOutputMode(adcCode, V_MIN_0V, V_RNG_0_10V);
-				break;
-			
-			case AD74413R_CURRENT_OUTPUT:
-				chVal	=	calcVoltageInCurrentOutputMode(adcCode, V_RNG_0_10V);
-				break;
+			if(!analyzeLiveStatus(pAPI) || !pAPI->liveStatusInfo.ADC_DATA_RDY)
+				return;
 			
-			case AD74413R_VOLTAGE_MEASUREMENT:
-				chVal	=	calcVoltageInVoltageInputMode(adcCode, V_MIN_0V, V_RNG_0_10V);
-				break;
-			
-			case AD74413R_CURRENT_MEASUREMENT:
-				chVal	=	calcCurrentInCurrentInputMode(adcCode, V_RNG_0_2P5V);
-				break;
+			readMask &= pAPI->seqCtrl.mask;
+		}
+		// результаты читаются только после завершения очередной последовательности
+		else if(pAPI->liveStatusGating)
+		{
+			if(!analyzeLiveStatus(pAPI) || !pAPI->liveStatusInfo.ADC_DATA_RDY)
+				return;
 			
-			case AD74413R_RESISTANCE_MEASUREMENT:
-				wireRes	=	pAPI->chInfo[chId].wireRes;
-				chVal		=	calcResistanceInResMeasMode(adcCode, wireRes);
-				break;
+			(void)SPI_writeFrame32(pAPI, AD74413_REG_LIVE_STATUS,
+														BITM_LIVE_STATUS_ADC_DATA_RDY,
+														false);
+		}
 			
-			default:
-				break;
+		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
+		{
+			if(readMask & (1 << chId))
+			{
+				(void)SPI_readFrame32(pAPI, AD74413_REG_ADC_RESULT0+chId);
+				data = pAPI->spiInfo.rxData;
+				
+				pAPI->chInfo[chId].adcCode = data;
+				pAPI->freshMask |= (1 << chId);
+			}
+		}
+		for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+		{
+			if(readMask & (1 << (diagId+4)))
+			{
+				(void)SPI_readFrame32(pAPI, AD74413_REG_DIAG_RESULT0+diagId);
+				data = pAPI->spiInfo.rxData;
+				
+				pAPI->diagInfo[diagId].diagCode = data;
+				pAPI->freshMask |= (1 << (diagId+4));
+			}
 		}
 		
-		pAPI->chInfo[chId].chVal = chVal;
-		
-		checkMinMax(pAPI, chId, chVal);
+		if(pAPI->seqCtrl.weighted)
+			startSequence(pAPI, nextSeqMask(pAPI));
 	}
 }
 
 
 //
-static float calcTemperature(uint16_t	DIAG_CODE)
+static inline  float calcCurrentInVoltageOutputMode(uint16_t	ADC_CODE,
+																										float			Vmin,
+																										float			Vrange)
 {
-	float temperature = 0.0f;
+	float current = 0.0f;
 	
-	temperature = (DIAG_CODE - 2034.0f) / 8.95f - 40.0f;
+	current = ((Vmin + ((ADC_CODE/ADC_DIGIT) * Vrange)) / R_SENSE) * 1000.0f;
 	
-	return temperature;
+	return current;
 }
 
+//
+static inline float calcVoltageInCurrentOutputMode(uint16_t	ADC_CODE,
+																									float			Vmin,
+																									float			Vrange)
+{
+	float voltage = 0.0f;
+	
+	voltage = Vmin + (ADC_CODE/ADC_DIGIT) * Vrange;
+	
+	return voltage;
+}
 
 //
-static float calcALDO5V(uint16_t	DIAG_CODE)
+static inline float calcVoltageInVoltageInputMode(uint16_t	ADC_CODE,
+																										float		Vmin,
+																										float		Vrange)
 {
-	float ALDO5V = 0.0f;
+	float voltage = 0.0f;
 	
-	ALDO5V = 7.0f * (DIAG_CODE / ADC_DIGIT) * V_RNG_0_2P5V;
+	voltage = Vmin + (ADC_CODE/ADC_DIGIT) * Vrange;
 	
-	return ALDO5V;
+	return voltage;
 }
 
+//
+static inline float calcCurrentInCurrentInputMode(uint16_t	ADC_CODE,
+																										float		Vmin,
+																										float		Vrange)
+{
+	float current = 0.0f;
+	
+	current = ((Vmin + (ADC_CODE/ADC_DIGIT) * Vrange) / R_SENSE) * 1000;
+	
+	return current;
+}
 
 //
-static void calcDiagRes(AD74413R_API *pAPI)
+static inline float calcResistanceInResMeasMode(uint16_t	ADC_CODE,
+																									float		wireRes)
 {
-	AD74413R_DIAGNOSTIC_MODE diagMode;
-	uint16_t	diagCode	=	0;
-	float			diagVal		=	0.0f;
+	float resistance = 0.0f;
+		
+	resistance = (ADC_CODE*R_PULL_UP) / (ADC_DIGIT-ADC_CODE) - wireRes;
+	
+	return resistance;
+}
+
+// температура термометра сопротивления по таблице; вне диапазона таблицы -
+// граница диапазона, обрыв и замыкание выявляет детектор неисправностей
+static float calcRtdTemperature(AD74413R_RTD_TYPE	rtdType,
+																float							resistance)
+{
+	int32_t	centiDeg	=	0;
+	
+	if(resistance < 0.0f)
+		resistance = 0.0f;
+	
+	(void)AD74413R_rtdToCentiDeg(rtdType, (uint32_t)(resistance*100 + 0.5f), &centiDeg);
+	
+	return centiDeg / 100.0f;
+}
+
+// температура холодного спая - последний результат диагностики TEMPERATURE
+// (слот или перебор источников), до первого результата - номинальная
+static float getCjcTemperature(AD74413R_API *pAPI)
+{
+	if(pAPI->diagRot.validMask & (1 << TEMPERATURE))
+		return calcTemperature(pAPI->diagRot.srcCode[TEMPERATURE]);
+	
+	return AD74413R_CJC_DEFAULT_DEG;
+}
+
+// источник назначен одному из слотов или входит в ротацию
+static bool isDiagScheduled(AD74413R_API *pAPI, AD74413R_DIAGNOSTIC_MODE diagSrc)
+{
+	if(pAPI->diagRot.slotMask && (pAPI->diagRot.srcMask & (1 << diagSrc)))
+		return true;
 	
 	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
 	{
-		diagMode	=	pAPI->diagInfo[diagId].diagMode;
-		diagCode	=	pAPI->diagInfo[diagId].diagCode;
-		
-		switch(diagMode)
+		if(pAPI->diagInfo[diagId].diagMode == diagSrc)
+			return true;
+	}
+	
+	return false;
+}
+
+// термопаре нужен холодный спай: TEMPERATURE добавляется в ротацию или
+// назначается первому свободному слоту; занятые слоты не трогаются,
+// и без свободного слота температура остаётся номинальной
+static void scheduleCjc(AD74413R_API *pAPI)
+{
+	if(isDiagScheduled(pAPI, TEMPERATURE))
+		return;
+	
+	if(pAPI->diagRot.slotMask)
+	{
+		pAPI->diagRot.srcMask |= (1 << TEMPERATURE);
+		return;
+	}
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pAPI->diagInfo[diagId].diagMode == DIAG_OFF)
 		{
-			case TEMPERATURE:
-				diagVal = calcTemperature(diagCode);
-				break;
-			
-			case ALDO5V:
-				diagVal = calcALDO5V(diagCode);
-				break;
-			
-			default:
-				break;
+			applyDiagMode(pAPI, diagId, TEMPERATURE);
+			return;
 		}
-		
-		pAPI->diagInfo[diagId].diagVal = diagVal;
 	}
 }
 
+// профиль без каналов термопар или с источником TEMPERATURE в одном из слотов
+static bool isProfileCjcScheduled(const tChProfile *pProfile)
+{
+	bool	needCjc	=	false;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(pProfile->chMode[chId] == AD74413R_THERMOCOUPLE_MEASUREMENT)
+			needCjc = true;
+	}
+	if(!needCjc)
+		return true;
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pProfile->diagMode[diagId] == TEMPERATURE)
+			return true;
+	}
+	
+	return false;
+}
 
-/* ==================== || ========== || ==================== */
-/* ==================== || USER LAYER || ==================== */
-/* ==================== \/ ========== \/ ==================== */
+// температура термопары в диапазоне ±104 мВ: ТЭДС считается в целых мкВ,
+// к ней прибавляется ТЭДС холодного спая; без типа - ТЭДС, мВ
+static float calcTcTemperature(AD74413R_API	*pAPI,
+																AD74413R_TC_TYPE	tcType,
+																uint16_t			ADC_CODE)
+{
+	int32_t	microVolt	=	0;
+	int32_t	centiDeg	=	0;
+	float		cjcDeg		=	0.0f;
+	
+	microVolt = UV_MIN_M0P104V
+							+ (int32_t)(((uint64_t)ADC_CODE*UV_RNG_M0P104V_0P104V + (uint16_t)ADC_DIGIT/2)
+													/ (uint16_t)ADC_DIGIT);
+	
+	if(tcType == AD74413R_TC_NONE)
+		return microVolt / 1000.0f;
+	
+	cjcDeg = getCjcTemperature(pAPI);
+	microVolt += AD74413R_tcToMicroVolt(tcType, (int32_t)(cjcDeg*100 + ((cjcDeg < 0.0f)?-0.5f:0.5f)));
+	(void)AD74413R_tcToCentiDeg(tcType, microVolt, &centiDeg);
+	
+	return centiDeg / 100.0f;
+}
 
 
-// сброс
-void	AD74413R_hwReset(void)
+// диапазоны автоматического выбора, от широкого к узкому
+static const uint16_t	autoRangeLadder[]		=	{	ENUM_ADC_CONFIG_RNG_0_10V,
+																						ENUM_ADC_CONFIG_RNG_0_2P5V,
+																						ENUM_ADC_CONFIG_RNG_NEG0P104_0P104V	};
+static const float		autoRangeMaxVolt[]	=	{	V_MAX_10V,
+																						V_MAX_2P5V,
+																						-V_MIN_M0P104V	};
+
+// границы диапазона АЦП по значению ADC_CONFIG
+static void getAdcRange(uint16_t	adcConfig,
+												float			*pVmin,
+												float			*pVrange)
 {
-	delay_ms(MDR_TIMER2, 20);
-	PORT_ResetBits(DO_AD74413R_RST_PORT, DO_AD74413R_RST_PIN);
-	delay_ms(MDR_TIMER2, 1);
-	PORT_SetBits(DO_AD74413R_RST_PORT, DO_AD74413R_RST_PIN);
-	delay_ms(MDR_TIMER2, 50);
+	switch(adcConfig & BITM_ADC_CONFIG_RANGE)
+	{
+		case ENUM_ADC_CONFIG_RNG_0_2P5V:
+			*pVmin		=	V_MIN_0V;
+			*pVrange	=	V_RNG_0_2P5V;
+			break;
+		
+		case ENUM_ADC_CONFIG_RNG_NEG2P5_0V:
+			*pVmin		=	V_MIN_M2P5V;
+			*pVrange	=	V_RNG_M2P5V_0V;
+			break;
+		
+		case ENUM_ADC_CONFIG_RNG_NEG2P5_2P5V:
+			*pVmin		=	V_MIN_M2P5V;
+			*pVrange	=	V_RNG_M2P5V_2P5V;
+			break;
+		
+		case ENUM_ADC_CONFIG_RNG_NEG0P104_0P104V:
+			*pVmin		=	V_MIN_M0P104V;
+			*pVrange	=	V_RNG_M0P104V_0P104V;
+			break;
+		
+		case ENUM_ADC_CONFIG_RNG_0_10V:
+		default:
+			*pVmin		=	V_MIN_0V;
+			*pVrange	=	V_RNG_0_10V;
+			break;
+	}
+}
+
+// слоты следующей одиночной последовательности: слот с периодом N
+// входит в каждую N-ю, последовательности без слотов пропускаются
+static uint8_t nextSeqMask(AD74413R_API *pAPI)
+{
+	uint8_t	seqMask	=	0;
+	uint8_t	period	=	0;
+	
+	for(uint16_t step = 0; (seqMask == 0) && (step <= UINT8_MAX); step++)
+	{
+		pAPI->seqCtrl.count++;
+		
+		for(uint8_t slot = 0; slot < AD74413R_NUMBER_OF_SEQ_SLOTS; slot++)
+		{
+			if(!(pAPI->chUsage & (1 << slot)))
+				continue;
+			
+			period = pAPI->seqCtrl.period[slot];
+			if((period <= 1) || ((pAPI->seqCtrl.count % period) == 0))
+				seqMask |= (1 << slot);
+		}
+	}
+	
+	return seqMask;
+}
+
+// запуск одиночной последовательности по маске слотов; ADC_CONV_CTRL
+// не проверяется чтением - по окончании последовательности CONV_SEQ сбрасывается
+static void startSequence(AD74413R_API *pAPI, uint8_t seqMask)
+{
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_LIVE_STATUS,
+												BITM_LIVE_STATUS_ADC_DATA_RDY,
+												false);
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+												ENUM_ADC_CONV_CTRL_SINGLE
+												|seqMask,
+												false);
+	pAPI->seqCtrl.mask = seqMask;
+}
+
+// возобновление преобразований по текущей маске каналов
+static void restartConversions(AD74413R_API *pAPI)
+{
+	// спящий чип остаётся с выключенным АЦП до пробуждения
+	if((pAPI->chUsage != 0) && (pAPI->chipState != CHIP_IN_SLEEP))
+	{
+		// АЦП остаётся включённым и ждёт запуска по запросу
+		if(pAPI->seqCtrl.onDemand)
+		{
+			(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+														ENUM_ADC_CONV_CTRL_IDLE
+														|pAPI->chUsage,
+														true);
+		}
+		else if(pAPI->seqCtrl.weighted)
+		{
+			// первая последовательность после перезапуска содержит все слоты
+			pAPI->seqCtrl.count = 0;
+			startSequence(pAPI, pAPI->chUsage);
+		}
+		else
+		{
+			(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+														ENUM_ADC_CONV_CTRL_CONTINUOUS
+														|pAPI->chUsage,
+														true);
+		}
+	}
+	else
+	{
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+													ENUM_ADC_CONV_CTRL_ADC_PWRDWN,
+													true);
+	}
+}
+
+// запись ADC_CONFIG канала при остановленном АЦП
+static AD74413R_RESULT writeAdcConfig(AD74413R_API	*pAPI,
+																			uint8_t				chId,
+																			uint16_t			adcConfig)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+												ENUM_ADC_CONV_CTRL_IDLE
+												|pAPI->chUsage,
+												true);
+	
+	result = SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONFIG0+chId,
+														adcConfig,
+														true);
+	if(result == AD74413R_RESULT_OK)
+	{
+		pAPI->chInfo[chId].adcConfig = adcConfig;
+		// коды разных диапазонов в одной статистике несопоставимы
+		pAPI->chInfo[chId].spikeFilter.fill = 0;
+		AD74413R_statsRequestReset(&pAPI->chInfo[chId].stats);
+		AD74413R_windowRequestReset(&pAPI->chInfo[chId].window);
+	}
+	
+	restartConversions(pAPI);
+	
+	return result;
+}
+
+// согласование ADC_CONFIG после смены функции канала:
+// чип сам выставляет диапазон и вход АЦП под функцию, поверх применяются
+// скорость преобразования и выбранный пользователем диапазон
+static void syncAdcConfig(AD74413R_API *pAPI, uint8_t chId)
+{
+	if(SPI_readFrame32(pAPI, AD74413_REG_ADC_CONFIG0+chId) != AD74413R_RESULT_OK)
+		return;
+	
+	storeAdcConfig(pAPI, chId, pAPI->spiInfo.rxData);
+}
+
+// применение скорости и диапазона пользователя к ADC_CONFIG, выставленному чипом
+static void storeAdcConfig(AD74413R_API *pAPI, uint8_t chId, uint16_t chipConfig)
+{
+	uint16_t	adcConfig		=	0;
+	
+	adcConfig = (chipConfig & ~BITM_ADC_CONFIG_EN_50_60_HZ)
+							|(pAPI->chInfo[chId].adcConfig & BITM_ADC_CONFIG_EN_50_60_HZ);
+	if(pAPI->chInfo[chId].chMode == AD74413R_THERMOCOUPLE_MEASUREMENT)
+	{
+		adcConfig = (adcConfig & ~BITM_ADC_CONFIG_RANGE)|ENUM_ADC_CONFIG_RNG_NEG0P104_0P104V;
+	}
+	else if(pAPI->chInfo[chId].userRange)
+	{
+		adcConfig = (adcConfig & ~BITM_ADC_CONFIG_RANGE)
+								|(pAPI->chInfo[chId].adcConfig & BITM_ADC_CONFIG_RANGE);
+	}
+	
+	pAPI->chInfo[chId].adcConfig = chipConfig;
+	if(adcConfig != chipConfig)
+	{
+		if(SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONFIG0+chId, adcConfig, true) == AD74413R_RESULT_OK)
+			pAPI->chInfo[chId].adcConfig = adcConfig;
+	}
+	pAPI->chInfo[chId].rangeReqPending	=	false;
+	pAPI->chInfo[chId].rangeSettle			=	0;
+}
+
+// выбор диапазона по последнему результату, запись откладывается до applyAutoRange
+static void checkAutoRange(AD74413R_API *pAPI, uint8_t chId)
+{
+	uint8_t		ladderSize	=	sizeof(autoRangeLadder)/sizeof(autoRangeLadder[0]);
+	uint8_t		widest			=	0;
+	uint8_t		rngId				=	0;
+	uint16_t	adcCode			=	pAPI->chInfo[chId].adcCode;
+	float			Vmin				=	0.0f;
+	float			Vrange			=	0.0f;
+	float			vIn					=	0.0f;
+	
+	// диапазон 0..10 В для токового входа не имеет смысла
+	if(pAPI->chInfo[chId].chMode == AD74413R_CURRENT_MEASUREMENT)
+		widest = 1;
+	else if(pAPI->chInfo[chId].chMode != AD74413R_VOLTAGE_MEASUREMENT)
+		return;
+	
+	while((rngId < ladderSize)
+				&& (autoRangeLadder[rngId] != (pAPI->chInfo[chId].adcConfig & BITM_ADC_CONFIG_RANGE)))
+	{
+		rngId++;
+	}
+	if(rngId >= ladderSize)
+		return;
+	
+	getAdcRange(pAPI->chInfo[chId].adcConfig, &Vmin, &Vrange);
+	vIn = Vmin + (adcCode/ADC_DIGIT) * Vrange;
+	if(vIn < 0.0f)
+		vIn = -vIn;
+	
+	// насыщение - переход на более широкий диапазон
+	if((adcCode >= (0xFFFF - AD74413R_AUTORANGE_SAT_CODE))
+			|| ((Vmin < 0.0f) && (adcCode <= AD74413R_AUTORANGE_SAT_CODE)))
+	{
+		if(rngId > widest)
+		{
+			pAPI->chInfo[chId].rangeReq					=	autoRangeLadder[rngId-1];
+			pAPI->chInfo[chId].rangeReqPending	=	true;
+		}
+	}
+	// значение с запасом укладывается в более узкий диапазон
+	else if((rngId+1 < ladderSize) && (vIn < autoRangeMaxVolt[rngId+1] * AD74413R_AUTORANGE_MARGIN))
+	{
+		pAPI->chInfo[chId].rangeReq					=	autoRangeLadder[rngId+1];
+		pAPI->chInfo[chId].rangeReqPending	=	true;
+	}
+}
+
+// применение запрошенных автовыбором диапазонов
+static void applyAutoRange(AD74413R_API *pAPI)
+{
+	uint16_t adcConfig = 0;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
+	{
+		if(pAPI->chInfo[chId].rangeReqPending)
+		{
+			pAPI->chInfo[chId].rangeReqPending = false;
+			
+			adcConfig = (pAPI->chInfo[chId].adcConfig & ~BITM_ADC_CONFIG_RANGE)
+									|pAPI->chInfo[chId].rangeReq;
+			
+			if(writeAdcConfig(pAPI, chId, adcConfig) == AD74413R_RESULT_OK)
+			{
+				// первые результаты после переключения могут относиться к старому диапазону
+				pAPI->chInfo[chId].rangeSettle = AD74413R_AUTORANGE_SETTLE_SAMPLES;
+			}
+		}
+	}
+}
+
+
+// элемент сортирующей сети
+static inline void sortPair(uint16_t *pA, uint16_t *pB)
+{
+	uint16_t tmp;
+	
+	if(*pA > *pB)
+	{
+		tmp	=	*pA;
+		*pA	=	*pB;
+		*pB	=	tmp;
+	}
+}
+
+
+// медиана трёх кодов, массив сортируется на месте
+static inline uint16_t median3(uint16_t *pCodes)
+{
+	sortPair(&pCodes[0], &pCodes[1]);
+	sortPair(&pCodes[1], &pCodes[2]);
+	sortPair(&pCodes[0], &pCodes[1]);
+	
+	return pCodes[1];
+}
+
+
+// медиана пяти кодов, массив сортируется на месте (сеть из 9 сравнений)
+static inline uint16_t median5(uint16_t *pCodes)
+{
+	sortPair(&pCodes[0], &pCodes[1]);
+	sortPair(&pCodes[3], &pCodes[4]);
+	sortPair(&pCodes[2], &pCodes[4]);
+	sortPair(&pCodes[2], &pCodes[3]);
+	sortPair(&pCodes[0], &pCodes[3]);
+	sortPair(&pCodes[0], &pCodes[2]);
+	sortPair(&pCodes[1], &pCodes[4]);
+	sortPair(&pCodes[1], &pCodes[3]);
+	sortPair(&pCodes[1], &pCodes[2]);
+	
+	return pCodes[2];
+}
+
+
+// подавление одиночных выбросов по последним отсчётам канала:
+// медиана 3/5 - выход всегда медиана окна,
+// Хампель - новый отсчёт заменяется медианой, только если отклоняется от неё
+// больше чем на K*1.5*MAD (оценка СКО), но не меньше AD74413R_SPIKE_MIN_DEV
+static uint16_t filterSpike(tSpikeFilter *pFilter, uint16_t adcCode)
+{
+	uint16_t	codes[AD74413R_SPIKE_WINDOW];
+	uint8_t		size		=	(pFilter->mode == AD74413R_FILTER_MEDIAN3)?3:5;
+	uint16_t	median	=	0;
+	uint16_t	mad			=	0;
+	uint16_t	dev			=	0;
+	uint32_t	limit		=	0;
+	
+	if(pFilter->mode == AD74413R_FILTER_OFF)
+		return adcCode;
+	
+	pFilter->hist[pFilter->pos] = adcCode;
+	pFilter->pos = (pFilter->pos + 1) % size;
+	if(pFilter->fill < size)
+	{
+		pFilter->fill++;
+		if(pFilter->fill < size)
+			return adcCode;
+	}
+	
+	for(uint8_t i = 0; i < size; i++)
+	{
+		codes[i] = pFilter->hist[i];
+	}
+	median = (size == 3)?median3(codes):median5(codes);
+	dev = (adcCode > median)?(adcCode - median):(median - adcCode);
+	
+	if(pFilter->mode == AD74413R_FILTER_HAMPEL5)
+	{
+		for(uint8_t i = 0; i < size; i++)
+		{
+			codes[i] = (pFilter->hist[i] > median)?(pFilter->hist[i] - median):(median - pFilter->hist[i]);
+		}
+		mad = median5(codes);
+		
+		limit = ((uint32_t)AD74413R_HAMPEL_K * 3 * mad) / 2;
+		if(limit < AD74413R_SPIKE_MIN_DEV)
+			limit = AD74413R_SPIKE_MIN_DEV;
+		
+		if(dev <= limit)
+			return adcCode;
+	}
+	else if(dev <= AD74413R_SPIKE_MIN_DEV)
+	{
+		return median;
+	}
+	
+	pFilter->rejected++;
+	
+	return median;
+}
+
+
+// пересчёт кода АЦП в значение канала по его текущей функции и диапазону
+static float calcChValue(AD74413R_API	*pAPI,
+													uint8_t				chId,
+													uint16_t			adcCode,
+													uint16_t			adcConfig)
+{
+	float	chVal		=	pAPI->chInfo[chId].chVal;
+	float	Vmin		=	0.0f;
+	float	Vrange	=	0.0f;
+	
+	getAdcRange(adcConfig, &Vmin, &Vrange);
+	
+	switch(pAPI->chInfo[chId].chMode)
+	{
+		case AD74413R_HIGH_IMPEDANCE:
+			chVal = 0.0f;
+			break;
+		
+		case AD74413R_VOLTAGE_OUTPUT:
+			chVal = calcCurrentInVoltageOutputMode(adcCode, Vmin, Vrange);
+			break;
+		
+		case AD74413R_CURRENT_OUTPUT:
+			chVal	=	calcVoltageInCurrentOutputMode(adcCode, Vmin, Vrange);
+			break;
+		
+		case AD74413R_VOLTAGE_MEASUREMENT:
+			chVal	=	calcVoltageInVoltageInputMode(adcCode, Vmin, Vrange);
+			break;
+		
+		case AD74413R_CURRENT_MEASUREMENT:
+			chVal	=	calcCurrentInCurrentInputMode(adcCode, Vmin, Vrange);
+			break;
+		
+		case AD74413R_RESISTANCE_MEASUREMENT:
+			chVal	=	calcResistanceInResMeasMode(adcCode, pAPI->chInfo[chId].wireRes);
+			if(pAPI->chInfo[chId].rtdType != AD74413R_RTD_NONE)
+				chVal = calcRtdTemperature(pAPI->chInfo[chId].rtdType, chVal);
+			break;
+		
+		case AD74413R_THERMOCOUPLE_MEASUREMENT:
+			chVal	=	calcTcTemperature(pAPI, pAPI->chInfo[chId].tcType, adcCode);
+			break;
+		
+		default:
+			break;
+	}
+	
+	return chVal;
+}
+
+
+// значение канала по последнему отсчёту, пересчёт не чаще одного раза на отсчёт;
+// диапазон берётся на момент отсчёта, т.к. к пересчёту он мог смениться
+static float getChVal(AD74413R_API *pAPI, uint8_t chId)
+{
+	tChannelInfo	*pCh	=	&pAPI->chInfo[chId];
+	
+	if(pCh->valSeq != pCh->codeSeq)
+	{
+		pCh->chVal	=	calcChValue(pAPI, chId, pCh->valCode, pCh->valAdcConfig);
+		pCh->valSeq	=	pCh->codeSeq;
+	}
+	
+	return pCh->chVal;
+}
+
+
+//
+static void calcAdcRes(AD74413R_API *pAPI)
+{
+	uint16_t	adcCode	=	0;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
+	{
+		// повторно пересчитывать старый результат нет смысла
+		if(!(pAPI->freshMask & (1 << chId)))
+			continue;
+		pAPI->freshMask &= ~(1 << chId);
+		
+		// результаты, полученные сразу после смены диапазона, не публикуются
+		if(pAPI->chInfo[chId].rangeSettle > 0)
+		{
+			pAPI->chInfo[chId].rangeSettle--;
+			continue;
+		}
+		
+		if(pAPI->chInfo[chId].autoRange)
+			checkAutoRange(pAPI, chId);
+		
+		adcCode	=	filterSpike(&pAPI->chInfo[chId].spikeFilter, pAPI->chInfo[chId].adcCode);
+		
+		pAPI->chInfo[chId].valCode			=	adcCode;
+		pAPI->chInfo[chId].valAdcConfig	=	pAPI->chInfo[chId].adcConfig;
+		pAPI->chInfo[chId].codeSeq++;
+		// в ленивом режиме значение считается при первом обращении
+		if(!pAPI->lazyValues)
+			(void)getChVal(pAPI, chId);
+		
+		// статистика ведётся по кодам, значения считаются только при запросе
+		AD74413R_statsUpdate(&pAPI->chInfo[chId].stats, adcCode);
+		AD74413R_windowPush(&pAPI->chInfo[chId].window, adcCode, msTicks);
+		
+		checkFault(pAPI, chId, adcCode);
+		calcRegulator(pAPI, chId);
+	}
+}
+
+
+// сравнение обратной связи SENSEL с заданием выхода напряжения,
+// выполняется только по свежему результату диагностики
+static void checkSense(AD74413R_API *pAPI, uint8_t chId)
+{
+	tChannelInfo							*pCh			=	&pAPI->chInfo[chId];
+	AD74413R_DIAGNOSTIC_MODE	senseSrc	=	(AD74413R_DIAGNOSTIC_MODE)(SENSEL_A + chId);
+	float											dev				=	0.0f;
+	
+	if(!(pAPI->diagRot.freshMask & (1 << senseSrc)))
+		return;
+	pAPI->diagRot.freshMask &= ~(1 << senseSrc);
+	
+	// во время рампы задание и выход расходятся штатно
+	if((pCh->chMode != AD74413R_VOLTAGE_OUTPUT) || pCh->ramp.active)
+	{
+		pCh->fault.senseErr = false;
+		return;
+	}
+	
+	dev = calcDiagValue(senseSrc, pAPI->diagRot.srcCode[senseSrc])
+				- (pCh->dacCode / VOLTAGE_DAC_CODE_FOR_1V);
+	if(dev < 0.0f)
+		dev = -dev;
+	
+	pCh->fault.senseErr = (dev > AD74413R_FAULT_SENSE_TOLERANCE);
+}
+
+
+// SENSEL, выбывший из слотов и ротации, больше не измеряется, и
+// checkSense не сбросит ошибку канала - она снимается здесь
+static void dropUnscheduledSense(AD74413R_API *pAPI)
+{
+	AD74413R_DIAGNOSTIC_MODE	senseSrc	=	DIAG_OFF;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		senseSrc = (AD74413R_DIAGNOSTIC_MODE)(SENSEL_A + chId);
+		if(isDiagScheduled(pAPI, senseSrc))
+			continue;
+		
+		pAPI->chInfo[chId].fault.senseErr	=	false;
+		pAPI->diagRot.freshMask						&=	~(1 << senseSrc);
+	}
+}
+
+
+// классификация результата канала по функции канала, VI_ERR и окну
+// допустимых значений; состояние меняется только после
+// AD74413R_FAULT_CONFIRM_SAMPLES одинаковых подряд оценок
+static void checkFault(AD74413R_API *pAPI, uint8_t chId, uint16_t adcCode)
+{
+	tChannelInfo					*pCh		=	&pAPI->chInfo[chId];
+	tChFault							*pFault	=	&pCh->fault;
+	AD74413R_FAULT_STATE	cand		=	AD74413R_FAULT_NONE;
+	bool									viErr		=	(pAPI->viErr & (1 << chId)) != 0;
+	
+	checkSense(pAPI, chId);
+	
+	switch(pCh->chMode)
+	{
+		// VI_ERR выхода напряжения - ограничение тока нагрузкой
+		case AD74413R_VOLTAGE_OUTPUT:
+			if(viErr)
+				cand = AD74413R_FAULT_SHORT_CIRCUIT;
+			else if(pFault->senseErr)
+				cand = AD74413R_FAULT_OPEN_WIRE;
+			break;
+		
+		// VI_ERR выхода тока - не хватает напряжения для заданного тока
+		case AD74413R_CURRENT_OUTPUT:
+			if(viErr)
+				cand = AD74413R_FAULT_OPEN_WIRE;
+			break;
+		
+		// насыщение делителя с подтяжкой R_PULL_UP - обрыв
+		case AD74413R_RESISTANCE_MEASUREMENT:
+			if(adcCode >= (uint16_t)ADC_DIGIT - AD74413R_AUTORANGE_SAT_CODE)
+				cand = AD74413R_FAULT_OPEN_WIRE;
+			else if(calcResistanceInResMeasMode(adcCode, pAPI->chInfo[chId].wireRes)
+								< AD74413R_FAULT_RES_SHORT_OHM)
+				cand = AD74413R_FAULT_SHORT_CIRCUIT;
+			break;
+		
+		default:
+			if(viErr)
+				cand = AD74413R_FAULT_VI_ERROR;
+			break;
+	}
+	
+	if((cand == AD74413R_FAULT_NONE) && pFault->windowEn)
+	{
+		if(getChVal(pAPI, chId) < pFault->minVal)
+			cand = AD74413R_FAULT_OPEN_WIRE;
+		else if(getChVal(pAPI, chId) > pFault->maxVal)
+			cand = AD74413R_FAULT_SHORT_CIRCUIT;
+	}
+	
+	if(cand == pFault->state)
+	{
+		pFault->confirm = 0;
+		return;
+	}
+	
+	if(cand != pFault->cand)
+	{
+		pFault->cand		=	cand;
+		pFault->confirm	=	0;
+	}
+	
+	if(++pFault->confirm >= AD74413R_FAULT_CONFIRM_SAMPLES)
+	{
+		pFault->state		=	cand;
+		pFault->confirm	=	0;
+		if(cand != AD74413R_FAULT_NONE)
+			pFault->count++;
+	}
+}
+
+
+// сброс детектора при смене функции канала; для токового входа
+// по умолчанию действует окно петли 4-20 мА
+static void resetFault(tChFault *pFault, AD74413R_CHANNEL_MODE chMode)
+{
+	pFault->state			=	AD74413R_FAULT_NONE;
+	pFault->cand			=	AD74413R_FAULT_NONE;
+	pFault->confirm		=	0;
+	pFault->senseErr	=	false;
+	pFault->windowEn	=	(chMode == AD74413R_CURRENT_MEASUREMENT);
+	pFault->minVal		=	AD74413R_FAULT_IIN_OPEN_MA;
+	pFault->maxVal		=	AD74413R_FAULT_IIN_SHORT_MA;
+}
+
+
+//
+static float calcTemperature(uint16_t	DIAG_CODE)
+{
+	float temperature = 0.0f;
+	
+	temperature = (DIAG_CODE - 2034.0f) / 8.95f - 40.0f;
+	
+	return temperature;
+}
+
+
+// коэффициенты делителей источников диагностики (по описанию DIAG_ASSIGN);
+// AVSS подаётся на АЦП через делитель со смещением и одним коэффициентом
+// не пересчитывается, поэтому V_AVSS не поддерживается и не назначается
+static const float diagScale[LVIN+1] =
+{
+	[AGND]			=	1.0f,
+	[AVDD]			=	16.0f,
+	[REFOUT]		=	1.0f/0.8f,
+	[ALDO5V]		=	7.0f,
+	[ALDO1V8]		=	2.33f,
+	[DLDO1V8]		=	3.0f,
+	[DVCC]			=	3.3f,
+	[IOVDD]			=	3.3f,
+	[SENSEL_A]	=	12.0f,
+	[SENSEL_B]	=	12.0f,
+	[SENSEL_C]	=	12.0f,
+	[SENSEL_D]	=	12.0f,
+	[LVIN]			=	1.0f,
+};
+
+// пересчёт кода диагностики (диапазон 0..2,5 В) в значение источника
+static float calcDiagValue(AD74413R_DIAGNOSTIC_MODE	diagMode,
+														uint16_t									DIAG_CODE)
+{
+	if(diagMode == TEMPERATURE)
+		return calcTemperature(DIAG_CODE);
+	if((diagMode == DIAG_OFF) || (diagMode == V_AVSS) || (diagMode > LVIN))
+		return 0.0f;
+	
+	return diagScale[diagMode] * (DIAG_CODE / ADC_DIGIT) * V_RNG_0_2P5V;
+}
+
+
+// значение слота диагностики по последнему отсчёту с кэшированием,
+// источник берётся на момент отсчёта (ротация могла его сменить)
+static float getDiagVal(AD74413R_API *pAPI, uint8_t diagId)
+{
+	tDiagnosticInfo	*pDiag	=	&pAPI->diagInfo[diagId];
+	
+	if(pDiag->valSeq != pDiag->codeSeq)
+	{
+		pDiag->diagVal	=	calcDiagValue(pDiag->valMode, pDiag->valCode);
+		pDiag->valSeq		=	pDiag->codeSeq;
+	}
+	
+	return pDiag->diagVal;
+}
+
+
+//
+static void calcDiagRes(AD74413R_API *pAPI)
+{
+	AD74413R_DIAGNOSTIC_MODE diagMode;
+	uint16_t	diagCode	=	0;
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(!(pAPI->freshMask & (1 << (diagId+4))))
+			continue;
+		pAPI->freshMask &= ~(1 << (diagId+4));
+		
+		// результаты, полученные сразу после назначения источника, не публикуются
+		if(pAPI->diagInfo[diagId].settle > 0)
+		{
+			pAPI->diagInfo[diagId].settle--;
+			continue;
+		}
+		
+		diagMode	=	pAPI->diagInfo[diagId].diagMode;
+		diagCode	=	pAPI->diagInfo[diagId].diagCode;
+		
+		pAPI->diagInfo[diagId].valMode	=	diagMode;
+		pAPI->diagInfo[diagId].valCode	=	diagCode;
+		pAPI->diagInfo[diagId].codeSeq++;
+		if(!pAPI->lazyValues)
+			(void)getDiagVal(pAPI, diagId);
+		
+		if((diagMode != DIAG_OFF) && (diagMode <= LVIN))
+		{
+			pAPI->diagRot.srcCode[diagMode]	=	diagCode;
+			pAPI->diagRot.validMask					|=	(1 << diagMode);
+			pAPI->diagRot.freshMask					|=	(1 << diagMode);
+		}
+	}
+}
+
+
+//
+static inline bool isDinMode(AD74413R_CHANNEL_MODE chMode)
+{
+	return ((chMode == AD74413R_DIGITAL_INPUT_LOGIC) || (chMode == AD74413R_DIGITAL_INPUT_LOOP));
+}
+
+
+// периодическое чтение аппаратных счётчиков импульсов цифровых входов,
+// 16-разрядный счётчик переполняется, поэтому накапливается разность по модулю 2^16
+// (корректно, пока за период приходит меньше 65536 импульсов)
+static void checkDinCounters(AD74413R_API *pAPI)
+{
+	uint32_t		now		=	msTicks;
+	uint32_t		dt		=	0;
+	uint16_t		delta	=	0;
+	tDinCounter	*pCnt;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(!isDinMode(pAPI->chInfo[chId].chMode)
+				|| !(pAPI->chInfo[chId].dinConfig & BITM_DIN_CONFIG_COUNT_EN))
+		{
+			continue;
+		}
+		
+		pCnt	=	&pAPI->chInfo[chId].dinCnt;
+		dt		=	now - pCnt->lastMs;
+		if(pCnt->valid && (dt < AD74413R_DIN_COUNTER_PERIOD_MS))
+			continue;
+		
+		if(SPI_readFrame32(pAPI, AD74413_REG_DIN_COUNTER0+chId) != AD74413R_RESULT_OK)
+			continue;
+		
+		// первое чтение только запоминает начальное значение счётчика
+		if(pCnt->valid)
+		{
+			delta				=	(uint16_t)(pAPI->spiInfo.rxData - pCnt->lastCnt);
+			pCnt->total	+=	delta;
+			pCnt->freq	=	(delta * 1000.0f) / dt;
+			pAPI->chInfo[chId].chVal = pCnt->freq;
+		}
+		pCnt->lastCnt	=	pAPI->spiInfo.rxData;
+		pCnt->lastMs	=	now;
+		pCnt->valid		=	true;
+	}
+}
+
+
+// снимок состояний компараторов всех цифровых входов одним кадром (DIN_COMP_OUT),
+// изменения относительно предыдущего снимка помещаются в очередь событий
+static AD74413R_RESULT readDinSnapshot(AD74413R_API *pAPI)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	tDinSnapshot		*pSnap	=	&pAPI->dinSnap;
+	uint8_t					state		=	0;
+	uint8_t					next		=	0;
+	
+	result = SPI_readFrame32(pAPI, AD74413_REG_DIN_COMP_OUT);
+	if(result != AD74413R_RESULT_OK)
+		return result;
+	
+	state = (uint8_t)(pAPI->spiInfo.rxData
+					& (BITM_DIN_COMP_OUT_DIN_COMP_OUT_A|BITM_DIN_COMP_OUT_DIN_COMP_OUT_B
+						|BITM_DIN_COMP_OUT_DIN_COMP_OUT_C|BITM_DIN_COMP_OUT_DIN_COMP_OUT_D));
+	
+	// первый снимок только фиксирует исходное состояние
+	if(!pSnap->valid)
+	{
+		pSnap->valid		=	true;
+		pSnap->state		=	state;
+		pSnap->rising		=	0;
+		pSnap->falling	=	0;
+		return result;
+	}
+	
+	pSnap->rising		=	state & ~pSnap->state;
+	pSnap->falling	=	~state & pSnap->state;
+	pSnap->state		=	state;
+	
+	if(pSnap->rising|pSnap->falling)
+	{
+		next = (pSnap->head + 1) % AD74413R_DIN_EVENT_QUEUE_SIZE;
+		if(next == pSnap->tail)
+		{
+			// очередь заполнена - событие теряется
+			pSnap->overflows++;
+		}
+		else
+		{
+			pSnap->queue[pSnap->head].ms				=	msTicks;
+			pSnap->queue[pSnap->head].state		=	state;
+			pSnap->queue[pSnap->head].rising		=	pSnap->rising;
+			pSnap->queue[pSnap->head].falling	=	pSnap->falling;
+			pSnap->head = next;
+		}
+	}
+	
+	return result;
+}
+
+
+// значение CH_FUNC_SETUP для функции канала
+static uint16_t chFuncSetup(AD74413R_CHANNEL_MODE chMode)
+{
+	switch(chMode)
+	{
+		case AD74413R_VOLTAGE_OUTPUT:					return ENUM_CH_FUNC_SETUP_VOUT;
+		case AD74413R_CURRENT_OUTPUT:					return ENUM_CH_FUNC_SETUP_IOUT;
+		case AD74413R_CURRENT_MEASUREMENT:		return ENUM_CH_FUNC_SETUP_IIN_EXT_PWR;
+		case AD74413R_VOLTAGE_MEASUREMENT:		return ENUM_CH_FUNC_SETUP_VIN;
+		case AD74413R_THERMOCOUPLE_MEASUREMENT:	return ENUM_CH_FUNC_SETUP_VIN;
+		case AD74413R_RESISTANCE_MEASUREMENT:	return ENUM_CH_FUNC_SETUP_RES_MEAS;
+		case AD74413R_DIGITAL_INPUT_LOGIC:		return ENUM_CH_FUNC_SETUP_DIN_LOGIC;
+		case AD74413R_DIGITAL_INPUT_LOOP:			return ENUM_CH_FUNC_SETUP_DIN_LOOP;
+		default:															return ENUM_CH_FUNC_SETUP_HIGH_IMP;
+	}
+}
+
+
+// функции, результаты которых берутся с АЦП; цифровые входы
+// используют только компаратор
+static inline bool isAdcMode(AD74413R_CHANNEL_MODE chMode)
+{
+	return (chFuncSetup(chMode) != ENUM_CH_FUNC_SETUP_HIGH_IMP) && !isDinMode(chMode);
+}
+
+
+// значение DIN_CONFIG для функции канала, false - регистр не меняется
+static bool chDinConfig(AD74413R_API						*pAPI,
+												uint8_t									chId,
+												AD74413R_CHANNEL_MODE		chMode,
+												uint16_t								*pDinConfig)
+{
+	switch(chMode)
+	{
+		case AD74413R_CURRENT_MEASUREMENT:
+		case AD74413R_VOLTAGE_MEASUREMENT:
+		case AD74413R_RESISTANCE_MEASUREMENT:
+		case AD74413R_THERMOCOUPLE_MEASUREMENT:
+			*pDinConfig = BITM_DIN_CONFIG_COMPARATOR_EN;
+			return true;
+		
+		case AD74413R_DIGITAL_INPUT_LOGIC:
+		case AD74413R_DIGITAL_INPUT_LOOP:
+			*pDinConfig = pAPI->chInfo[chId].dinConfig;
+			return true;
+		
+		default:
+			return false;
+	}
+}
+
+
+// сброс программного состояния канала при смене функции
+static void resetChState(AD74413R_API						*pAPI,
+													uint8_t									chId,
+													AD74413R_CHANNEL_MODE		chMode)
+{
+	pAPI->chInfo[chId].chMode		= chMode;
+	pAPI->chInfo[chId].dacCode	= 0x0000;
+	// значение старого режима не публикуется до первого нового результата
+	pAPI->chInfo[chId].chVal		= 0.0f;
+	pAPI->chInfo[chId].valSeq		= pAPI->chInfo[chId].codeSeq;
+	pAPI->chInfo[chId].dinCnt.valid	= false;
+	pAPI->chInfo[chId].dinCnt.freq	= 0.0f;
+	pAPI->chInfo[chId].dinCnt.total	= 0;
+	pAPI->chInfo[chId].ramp.active	= false;
+	pAPI->chInfo[chId].piCtrl.enabled	= false;
+	pAPI->chInfo[chId].spikeFilter.fill = 0;
+	AD74413R_statsRequestReset(&pAPI->chInfo[chId].stats);
+	AD74413R_windowRequestReset(&pAPI->chInfo[chId].window);
+	resetFault(&pAPI->chInfo[chId].fault, chMode);
+}
+
+
+// настройка функции канала
+static void applyChMode(AD74413R_API					*pAPI,
+												uint8_t								chId,
+												AD74413R_CHANNEL_MODE	chMode)
+{
+	uint16_t	funcSetup	=	chFuncSetup(chMode);
+	uint16_t	dinConfig	=	0;
+	
+	resetChState(pAPI, chId, chMode);
+	
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+													ENUM_ADC_CONV_CTRL_IDLE
+													|pAPI->chUsage,
+													true);
+	(void)SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+													0x0000,
+													true);
+	// смена функции всегда через HIGH_IMP
+	(void)SPI_writeFrame32(pAPI, (AD74413_REG_CH_FUNC_SETUP0+chId),
+													ENUM_CH_FUNC_SETUP_HIGH_IMP,
+													true);
+	
+	if(funcSetup != ENUM_CH_FUNC_SETUP_HIGH_IMP)
+	{
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
+														funcSetup,
+														true);
+	}
+	if(chDinConfig(pAPI, chId, chMode, &dinConfig))
+	{
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
+														dinConfig,
+														true);
+	}
+	
+	setChState(pAPI, chId, isAdcMode(chMode));
+	if(isAdcMode(chMode))
+		syncAdcConfig(pAPI, chId);
+	
+	restartConversions(pAPI);
+	
+	if(chMode == AD74413R_THERMOCOUPLE_MEASUREMENT)
+		scheduleCjc(pAPI);
+}
+
+
+// настройка диагностического канала
+static void applyDiagMode(AD74413R_API							*pAPI,
+													uint8_t										diagId,
+													AD74413R_DIAGNOSTIC_MODE	diagMode)
+{
+	pAPI->diagInfo[diagId].diagMode	= diagMode;
+	pAPI->diagInfo[diagId].diagVal	= 0.0f;
+	pAPI->diagInfo[diagId].valSeq		= pAPI->diagInfo[diagId].codeSeq;
+	pAPI->diagInfo[diagId].settle		= AD74413R_DIAG_SETTLE_SAMPLES;
+	
+	if((diagMode == DIAG_OFF) || (diagMode > LVIN))
+	{
+		setDiagState(pAPI, diagId, false);
+	}
+	else
+	{
+		setDiagState(pAPI, diagId, true);
+		(void)writeDiagAssign(pAPI, DIAG_ASSIGN_SET(pAPI->diagAssign, diagId, diagMode));
+	}
+	
+	restartConversions(pAPI);
+}
+
+
+// запись DIAG_ASSIGN целиком (по 4 бита на слот)
+static AD74413R_RESULT writeDiagAssign(AD74413R_API	*pAPI,
+																			uint16_t			diagAssign)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	
+	result = SPI_writeFrame32(pAPI, AD74413_REG_DIAG_ASSIGN,
+														diagAssign,
+														true);
+	if(result == AD74413R_RESULT_OK)
+		pAPI->diagAssign = diagAssign;
+	
+	return result;
+}
+
+
+// следующий по кругу источник из маски ротации
+static AD74413R_DIAGNOSTIC_MODE nextDiagSource(AD74413R_API *pAPI)
+{
+	AD74413R_DIAGNOSTIC_MODE	diagSrc	=	DIAG_OFF;
+	
+	for(uint8_t i = 0; i < LVIN; i++)
+	{
+		diagSrc					=	(AD74413R_DIAGNOSTIC_MODE)pAPI->diagRot.next;
+		pAPI->diagRot.next	=	(pAPI->diagRot.next < LVIN)?(pAPI->diagRot.next+1):AGND;
+		
+		if(pAPI->diagRot.srcMask & (1 << diagSrc))
+			return diagSrc;
+	}
+	
+	return DIAG_OFF;
+}
+
+
+// смена источников в слотах ротации одной записью DIAG_ASSIGN;
+// слоты уже включены в последовательность, поэтому АЦП не перезапускается
+static void applyDiagRotation(AD74413R_API *pAPI)
+{
+	uint16_t									diagAssign	=	pAPI->diagAssign;
+	AD74413R_DIAGNOSTIC_MODE	diagSrc			=	DIAG_OFF;
+	
+	if(pAPI->diagRot.slotMask == 0)
+		return;
+	if((msTicks - pAPI->diagRot.lastMs) < pAPI->diagRot.periodMs)
+		return;
+	pAPI->diagRot.lastMs = msTicks;
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pAPI->diagRot.slotMask & (1 << diagId))
+			diagAssign = DIAG_ASSIGN_SET(diagAssign, diagId, nextDiagSource(pAPI));
+	}
+	
+	if(writeDiagAssign(pAPI, diagAssign) != AD74413R_RESULT_OK)
+		return;
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pAPI->diagRot.slotMask & (1 << diagId))
+		{
+			diagSrc = (AD74413R_DIAGNOSTIC_MODE)(DIAG_ASSIGN_GET(diagAssign, diagId) + 1);
+			pAPI->diagInfo[diagId].diagMode	=	diagSrc;
+			pAPI->diagInfo[diagId].settle		=	AD74413R_DIAG_SETTLE_SAMPLES;
+		}
+	}
+}
+
+
+// время в мкс с предыдущего отсчёта таймера; интервалы между вызовами
+// должны быть короче периода 16-битного TIMEOUT_TIMER. Отсчёт сдвигается
+// только на целые мкс, остаток тиков переходит в следующий вызов
+static inline uint16_t elapsedUs(uint16_t *pLastTick)
+{
+	uint16_t	delta	=	(uint16_t)((uint16_t)TIMEOUT_TIMER->CNT - *pLastTick);
+	uint16_t	us		=	delta / AD74413R_TIMER_TICKS_PER_US;
+	
+	*pLastTick += us * AD74413R_TIMER_TICKS_PER_US;
+	
+	return us;
+}
+
+
+// ожидание завершения одиночной последовательности: по пину ADC_RDY
+// (активный низкий), если он подключён, иначе по ADC_DATA_RDY в LIVE_STATUS
+static AD74413R_RESULT waitAdcReady(AD74413R_API *pAPI, uint32_t *pLatencyUs)
+{
+	uint16_t	lastTick	=	TIMEOUT_TIMER->CNT;
+	bool			ready			=	false;
+	
+	while(!ready)
+	{
+		if(pAPI->pinsInfo.adcRdyPORTx)
+			ready = !PORT_ReadInputDataBit(pAPI->pinsInfo.adcRdyPORTx, pAPI->pinsInfo.adcRdyPORT_Pin);
+		else
+			ready = analyzeLiveStatus(pAPI) && pAPI->liveStatusInfo.ADC_DATA_RDY;
+		
+		*pLatencyUs += elapsedUs(&lastTick);
+		
+		if(!ready && (*pLatencyUs > AD74413R_SINGLE_TIMEOUT_US))
+			return ad74413_RESULT_FAILURE;
+	}
+	
+	return AD74413R_RESULT_OK;
+}
+
+
+// установка периода слота; взвешенный опрос включается, пока хотя бы
+// у одного слота период больше 1
+static void setSeqPeriod(AD74413R_API *pAPI, uint8_t slot, uint8_t period)
+{
+	bool	weighted	=	false;
+	
+	pAPI->seqCtrl.period[slot] = period;
+	
+	for(uint8_t i = 0; i < AD74413R_NUMBER_OF_SEQ_SLOTS; i++)
+	{
+		if(pAPI->seqCtrl.period[i] > 1)
+			weighted = true;
+	}
+	
+	if(weighted != pAPI->seqCtrl.weighted)
+	{
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+													ENUM_ADC_CONV_CTRL_IDLE
+													|pAPI->chUsage,
+													true);
+		pAPI->seqCtrl.weighted = weighted;
+		restartConversions(pAPI);
+	}
+}
+
+
+// конфигурация чипа по данным драйвера в порядке записи: функция канала
+// первой, т.к. при её записи чип выставляет ADC_CONFIG по умолчанию
+static uint8_t buildChipConfig(AD74413R_API *pAPI, tRegister *pRegs)
+{
+	uint8_t		count			=	0;
+	uint16_t	dinConfig	=	0;
+	
+	// уровни параллельных GPO до переключения пинов на GPO_PARALLEL
+	pRegs[count].regAdr			=	AD74413_REG_GPO_PARALLEL;
+	pRegs[count++].regData	=	pAPI->gpoParallel;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(!chDinConfig(pAPI, chId, pAPI->chInfo[chId].chMode, &dinConfig))
+			dinConfig = pAPI->chInfo[chId].dinConfig;
+		
+		pRegs[count].regAdr			=	AD74413_REG_CH_FUNC_SETUP0+chId;
+		pRegs[count++].regData	=	chFuncSetup(pAPI->chInfo[chId].chMode);
+		pRegs[count].regAdr			=	AD74413_REG_ADC_CONFIG0+chId;
+		pRegs[count++].regData	=	pAPI->chInfo[chId].adcConfig;
+		pRegs[count].regAdr			=	AD74413_REG_DIN_CONFIG0+chId;
+		pRegs[count++].regData	=	dinConfig;
+		pRegs[count].regAdr			=	AD74413_REG_GPO_CONFIG0+chId;
+		pRegs[count++].regData	=	pAPI->chInfo[chId].gpoConfig;
+		pRegs[count].regAdr			=	AD74413_REG_DAC_CLR_CODE0+chId;
+		pRegs[count++].regData	=	pAPI->chInfo[chId].clrCode;
+		pRegs[count].regAdr			=	AD74413_REG_OUTPUT_CONFIG0+chId;
+		pRegs[count++].regData	=	pAPI->chInfo[chId].outputConfig;
+		pRegs[count].regAdr			=	AD74413_REG_DAC_CODE0+chId;
+		pRegs[count++].regData	=	pAPI->chInfo[chId].dacCode;
+	}
+	
+	pRegs[count].regAdr			=	AD74413_REG_DIN_THRESH;
+	pRegs[count++].regData	=	pAPI->dinThresh;
+	pRegs[count].regAdr			=	AD74413_REG_DIAG_ASSIGN;
+	pRegs[count++].regData	=	pAPI->diagAssign;
+	pRegs[count].regAdr			=	AD74413_REG_ALERT_MASK;
+	pRegs[count++].regData	=	pAPI->alertCtrl.mask;
+	
+	return count;
+}
+
+
+// позиция регистра конфигурации в результате readChipConfig
+static inline uint8_t readbackIdx(uint8_t regAdr)
+{
+	return (regAdr == AD74413_REG_ALERT_MASK)?RECOVERY_READBACK_COUNT:(regAdr - RECOVERY_READBACK_FIRST);
+}
+
+
+// чтение регистров конфигурации одним пакетом, ALERT_MASK - последним
+static AD74413R_RESULT readChipConfig(AD74413R_API *pAPI, uint16_t *pReadback)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	
+	result = SPI_readBurst32(pAPI, RECOVERY_READBACK_FIRST, RECOVERY_READBACK_COUNT, pReadback);
+	
+	if(result == AD74413R_RESULT_OK)
+		result = SPI_readFrame32(pAPI, AD74413_REG_ALERT_MASK);
+	if(result == AD74413R_RESULT_OK)
+		pReadback[RECOVERY_READBACK_COUNT] = pAPI->spiInfo.rxData;
+	
+	return result;
+}
+
+
+// восстановление конфигурации чипа по данным драйвера: записываются только
+// расходящиеся регистры (после сброса - почти все), для канала со сменой
+// функции - все его регистры; затем сверка чтением. Пакет передаётся в три
+// этапа: перевод каналов в HIGH_IMP, конфигурация, коды ЦАП каналов со сменой
+// функции - с выдержками AD74413R_HIGH_IMP_SETTLE_US и AD74413R_DAC_SETTLE_US.
+// Состояние драйвера (рампы, регуляторы, статистика) не меняется
+static AD74413R_RESULT restoreChipConfig(AD74413R_API *pAPI)
+{
+	AD74413R_RESULT	result			=	AD74413R_RESULT_OK;
+	tRegister				config[RECOVERY_CONFIG_FRAMES];
+	tRegister				regs[RECOVERY_MAX_FRAMES];
+	tRegister				dacRegs[AD74413R_NUMBER_OF_CHANNELS];
+	uint16_t				readback[RECOVERY_READBACK_COUNT + 1];
+	uint8_t					configCount	=	buildChipConfig(pAPI, config);
+	uint8_t					count				=	0;
+	uint8_t					hizCount		=	0;
+	uint8_t					dacFirst		=	0;
+	uint8_t					dacCount		=	0;
+	uint8_t					funcMask		=	0;
+	uint8_t					chId				=	0;
+	uint8_t					funcIdx			=	0;
+	bool						perCh				=	false;
+	bool						differs			=	false;
+	
+	result = readChipConfig(pAPI, readback);
+	if(result != AD74413R_RESULT_OK)
+		return result;
+	
+	regs[count].regAdr			=	AD74413_REG_ADC_CONV_CTRL;
+	regs[count++].regData		=	ENUM_ADC_CONV_CTRL_IDLE | pAPI->chUsage;
+	
+	// смена функции всегда через HIGH_IMP
+	for(chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		funcIdx = RECOVERY_CH_FIRST + chId*RECOVERY_CH_FRAMES;
+		
+		if(config[funcIdx].regData == readback[readbackIdx(config[funcIdx].regAdr)])
+			continue;
+		
+		funcMask |= (1 << chId);
+		
+		if(readback[readbackIdx(config[funcIdx].regAdr)] != ENUM_CH_FUNC_SETUP_HIGH_IMP)
+		{
+			regs[count].regAdr			=	AD74413_REG_DAC_CODE0+chId;
+			regs[count++].regData		=	0x0000;
+			regs[count].regAdr			=	AD74413_REG_CH_FUNC_SETUP0+chId;
+			regs[count++].regData		=	ENUM_CH_FUNC_SETUP_HIGH_IMP;
+		}
+	}
+	hizCount = count;
+	
+	// код ЦАП канала со сменой функции записывается после её установки
+	for(uint8_t i = 0; i < configCount; i++)
+	{
+		perCh		=	(i >= RECOVERY_CH_FIRST)
+								&& (i < RECOVERY_CH_FIRST + RECOVERY_CH_FRAMES*AD74413R_NUMBER_OF_CHANNELS);
+		chId		=	(i - RECOVERY_CH_FIRST) / RECOVERY_CH_FRAMES;
+		differs	=	(config[i].regData != readback[readbackIdx(config[i].regAdr)]);
+		
+		if(perCh && (funcMask & (1 << chId)))
+		{
+			if(config[i].regAdr == AD74413_REG_DAC_CODE0+chId)
+				dacRegs[dacCount++] = config[i];
+			else
+				regs[count++] = config[i];
+		}
+		else if(differs)
+		{
+			regs[count++] = config[i];
+		}
+	}
+	dacFirst = count;
+	for(uint8_t i = 0; i < dacCount; i++)
+		regs[count++] = dacRegs[i];
+	
+	if(count > 1)
+	{
+		result = SPI_writeBatch(pAPI, regs, hizCount);
+		
+		if(result == AD74413R_RESULT_OK)
+		{
+			if(hizCount > 1)
+				waitUs(AD74413R_HIGH_IMP_SETTLE_US);
+			result = SPI_writeBatch(pAPI, &regs[hizCount], dacFirst - hizCount);
+		}
+		
+		if((result == AD74413R_RESULT_OK) && (dacCount > 0))
+		{
+			waitUs(AD74413R_DAC_SETTLE_US);
+			result = SPI_writeBatch(pAPI, &regs[dacFirst], dacCount);
+		}
+		
+		if(result == AD74413R_RESULT_OK)
+			result = readChipConfig(pAPI, readback);
+		
+		for(uint8_t i = 0; (i < configCount) && (result == AD74413R_RESULT_OK); i++)
+		{
+			if(config[i].regData != readback[readbackIdx(config[i].regAdr)])
+				result = AD74413R_RESULT_REG_WRONG_DATA_IS_WRITTEN;
+		}
+		
+		if(result == AD74413R_RESULT_OK)
+			pAPI->recovery.replayCount++;
+	}
+	
+	// последовательность АЦП могла быть остановлена или потеряна
+	restartConversions(pAPI);
+	
+	return result;
+}
+
+
+/* ==================== || ========== || ==================== */
+/* ==================== || USER LAYER || ==================== */
+/* ==================== \/ ========== \/ ==================== */
+
+
+// сброс
+void	AD74413R_hwReset(void)
+{
+	delay_ms(MDR_TIMER2, 20);
+	PORT_ResetBits(DO_AD74413R_RST_PORT, DO_AD74413R_RST_PIN);
+	delay_ms(MDR_TIMER2, 1);
+	PORT_SetBits(DO_AD74413R_RST_PORT, DO_AD74413R_RST_PIN);
+	delay_ms(MDR_TIMER2, 50);
+}
+
+
+// инициализация чипа; при отсутствии ответа чип остаётся CHIP_UNUSED
+// и обработчиком не опрашивается
+AD74413R_RESULT	AD74413R_init(uint8_t					API_ref,
+								MDR_SSP_TypeDef			*SSPx,
+								MDR_PORT_TypeDef*		csPORTx,
+								uint32_t						csPORT_Pin,
+								MDR_PORT_TypeDef*		rstPORTx,
+								uint32_t						rstPORT_Pin,
+								MDR_PORT_TypeDef*		adcRdyPORTx,
+								uint32_t						adcRdyPORT_Pin)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		initialiseAPI(pAPI,	API_ref,
+									SSPx,	csPORTx,	csPORT_Pin,
+									rstPORTx,	rstPORT_Pin,
+									adcRdyPORTx,	adcRdyPORT_Pin);
+		
+		// незапаянный чип не стоит ожидания программного сброса
+		if(!probeChip(pAPI))
+			return ad74413_RESULT_INACTIVE_CHIP;
+		
+		pAPI->chipState = CHIP_IN_USE;
+		
+		// сброс очищает и RESET_OCCURRED включения питания
+		result = SPI_softwareReset(pAPI);
+		
+		// первая же ошибка прерывает настройку: чип остаётся CHIP_IN_USE
+		// и обработчиком не опрашивается
+		for(uint8_t chId = 0; (chId < AD74413R_NUMBER_OF_ADC_CHANNELS) && (result == AD74413R_RESULT_OK); chId++)
+		{
+			pAPI->chInfo[chId].adcConfig = AD74413R_DEFAULT_ADC_RATE;
+			pAPI->chInfo[chId].gpoConfig = ENUM_GPO_CONFIG_SEL_GPDATA;
+			pAPI->chInfo[chId].dinConfig = BITM_DIN_CONFIG_COMPARATOR_EN;
+			result = SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONFIG0+chId,
+										pAPI->chInfo[chId].adcConfig,
+										true);
+			if(result == AD74413R_RESULT_OK)
+				result = SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
+											pAPI->chInfo[chId].dinConfig,
+											true);
+			if(result == AD74413R_RESULT_OK)
+				result = SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
+											pAPI->chInfo[chId].gpoConfig,
+											true);
+		}
+		
+		if(result == AD74413R_RESULT_OK)
+			pAPI->chipState = CHIP_IN_WORK;
+	}
+	
+	return result;
+}
+
+
+// программный сброс одного чипа с восстановлением его конфигурации,
+// остальные чипы продолжают работу
+AD74413R_RESULT	AD74413R_resetChip(uint8_t	API_ref)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		result = SPI_softwareReset(pAPI);
+		
+		if(result == AD74413R_RESULT_OK)
+		{
+			pAPI->recovery.resetPending = true;
+			result = checkRecovery(pAPI);
+		}
+	}
+	
+	return result;
+}
+
+
+// счётчики сбросов чипа, отброшенных им кадров и восстановлений конфигурации
+bool	AD74413R_getRecoveryInfo(uint8_t				API_ref,
+																tRecoveryInfo	*pInfo)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(!pAPI || !pInfo)
+		return false;
+	
+	*pInfo = pAPI->recovery;
+	
+	return true;
+}
+
+
+// чтение и разбор текущего состояния чипа (LIVE_STATUS)
+void	AD74413R_analyzeChipStatus(uint8_t	API_ref)
+{
+	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		(void)analyzeLiveStatus(pAPI);
+	}
+}
+
+// чтение результатов АЦП только по готовности данных (ADC_DATA_RDY)
+void	AD74413R_setLiveStatusGating(uint8_t	API_ref,
+																	bool	enable)
+{
+	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		pAPI->liveStatusGating = enable;
+	}
+}
+
+
+// пробуждение чипа или перевод в сон: во сне АЦП выключен, выходы и
+// цифровые входы продолжают работу, обработчик к чипу не обращается
+// (рампы и регуляторы приостанавливаются, тревоги читаются после пробуждения)
+AD74413R_RESULT	AD74413R_turnChipInWork(uint8_t	API_ref,
+																				bool		inWork)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		if((pAPI->chipState != CHIP_IN_WORK) && (pAPI->chipState != CHIP_IN_SLEEP))
+			return ad74413_RESULT_INACTIVE_CHIP;
+		
+		if(inWork)
+		{
+			pAPI->chipState = CHIP_IN_WORK;
+			restartConversions(pAPI);
+			result = AD74413R_RESULT_OK;
+		}
+		else
+		{
+			result = SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+																ENUM_ADC_CONV_CTRL_ADC_PWRDWN,
+																true);
+			if(result == AD74413R_RESULT_OK)
+				pAPI->chipState = CHIP_IN_SLEEP;
+		}
+	}
+	
+	return result;
+}
+
+
+// состояние чипа (CHIP_x)
+uint8_t	AD74413R_getChipState(uint8_t	API_ref)
+{
+	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	
+	return pAPI?pAPI->chipState:CHIP_UNUSED;
+}
+
+
+// настройка маски тревог и режима их обработки
+AD74413R_RESULT	AD74413R_setAlertPolicy(uint8_t		API_ref,
+																				uint16_t	alertEnMask,
+																				bool			irqMode)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		// бит ALERT_MASK = 1 запрещает соответствующую тревогу на пине ALERT,
+		// RESET_OCCURRED не маскируется
+		pAPI->alertCtrl.mask = (uint16_t)(~alertEnMask) & (uint16_t)~BITM_ALERT_STATUS_RESET_OCCURRED;
+		
+		result = SPI_writeFrame32(pAPI, AD74413_REG_ALERT_MASK,
+															pAPI->alertCtrl.mask,
+															true);
+		
+		pAPI->alertCtrl.irqMode = irqMode;
+		// флаги, выставленные до разрешения прерывания, читаются на первом проходе
+		pAPI->alertCtrl.pending = true;
+	}
+	
+	return result;
+}
+
+// регистрация обработчика тревог
+AD74413R_RESULT	AD74413R_registerAlertHandler(uint8_t				API_ref,
+																							tAlertHandler	handler)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		result = ad74413_RESULT_NO_RESOURCES;
+		
+		for(uint8_t i = 0; i < AD74413R_MAX_ALERT_HANDLERS; i++)
+		{
+			if(pAPI->alertCtrl.handlers[i] == NULL)
+			{
+				pAPI->alertCtrl.handlers[i] = handler;
+				result = AD74413R_RESULT_OK;
+				break;
+			}
+		}
+	}
+	
+	return result;
+}
+
+// вызывается из прерывания по пину ALERT
+void	AD74413R_alertIrqHandler(uint8_t	API_ref)
+{
+	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		pAPI->alertCtrl.pending = true;
+	}
+}
+
+
+//
+void	AD74413R_setRegData(uint8_t		API_ref,
+													uint8_t		nRegAdr,
+													uint16_t	nRegData,
+															bool	validate)
+{
+	//AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	AD74413R_API 	*pAPI 	= getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		(void)SPI_writeFrame32(pAPI, nRegAdr, nRegData, validate);
+	}
+}
+
+//
+uint16_t	AD74413R_getRegData(uint8_t		API_ref,
+															uint8_t		nRegAdr)
+{
+	uint16_t				data		=	0;
+	AD74413R_API 	*pAPI 	= getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		(void)SPI_readFrame32(pAPI, nRegAdr);
+		data = pAPI->spiInfo.rxData;
+	}
+	
+	return data;
+}
+
+
+//
+void	AD74413R_setChMode(uint8_t	API_ref,
+												uint8_t		chId,
+					AD74413R_CHANNEL_MODE		chMode)
+{
+	AD74413R_API	*pAPI	= getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		applyChMode(pAPI, chId, chMode);
+	}
+}
+
+
+// выбор диапазона и скорости преобразования АЦП канала
+// (ENUM_ADC_CONFIG_RNG_x, ENUM_ADC_CONFIG_SPS_x; SPS_20 и SPS_10 включают подавление 50/60 Гц)
+AD74413R_RESULT	AD74413R_setAdcConfig(uint8_t		API_ref,
+																			uint8_t		chId,
+																			uint16_t	adcRange,
+																			uint16_t	adcRate)
+{
+	AD74413R_RESULT	result		=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI			=	getPtrFromRef(API_ref);
+	uint16_t				adcConfig	=	0;
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_ADC_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		// термопара измеряется только в диапазоне ±104 мВ, меняется лишь скорость
+		if(pAPI->chInfo[chId].chMode == AD74413R_THERMOCOUPLE_MEASUREMENT)
+			adcRange = ENUM_ADC_CONFIG_RNG_NEG0P104_0P104V;
+		
+		adcConfig = (pAPI->chInfo[chId].adcConfig & ~(BITM_ADC_CONFIG_RANGE|BITM_ADC_CONFIG_EN_50_60_HZ))
+								|(adcRange & BITM_ADC_CONFIG_RANGE)
+								|(adcRate & BITM_ADC_CONFIG_EN_50_60_HZ);
+		
+		pAPI->chInfo[chId].userRange				=	true;
+		pAPI->chInfo[chId].rangeReqPending	=	false;
+		pAPI->chInfo[chId].rangeSettle			=	0;
+		
+		result = writeAdcConfig(pAPI, chId, adcConfig);
+	}
+	
+	return result;
+}
+
+// автоматический выбор диапазона АЦП для каналов измерения напряжения и тока
+void	AD74413R_setAutoRange(uint8_t		API_ref,
+														uint8_t		chId,
+														bool			enable)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		pAPI->chInfo[chId].autoRange				=	enable;
+		pAPI->chInfo[chId].rangeReqPending	=	false;
+	}
+}
+
+
+//
+AD74413R_RESULT	AD74413R_setOutputVoltageOnCh(uint8_t		API_ref,
+																							uint8_t		chId,
+																							float			volt)
+{
+	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	AD74413R_API		*pAPI		=	NULL;
+	uint16_t				dacCode = 0;
+	
+	if(volt >= VOLTAGE_OUTPUT_MIN && volt <= VOLTAGE_OUTPUT_MAX)
+	{
+		pAPI	= getPtrFromRef(API_ref);
+		
+		if(pAPI)
+		{
+			if(pAPI->chInfo[chId].chMode == AD74413R_VOLTAGE_OUTPUT)
+			{
+				dacCode = calcDacCodeForVoltage(volt);
+				
+				pAPI->chInfo[chId].ramp.active		=	false;
+				pAPI->chInfo[chId].piCtrl.enabled	=	false;
+				(void)writeOutputConfig(pAPI, chId,
+																pAPI->chInfo[chId].outputConfig
+																& ~(BITM_OUTPUT_CONFIG_SLEW_EN|BITM_OUTPUT_CONFIG_SLEW_LIN_STEP
+																		|BITM_OUTPUT_CONFIG_SLEW_LIN_RATE));
+				
+				result = SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+																	dacCode,
+																	true);
+				if(result == AD74413R_RESULT_OK)
+					pAPI->chInfo[chId].dacCode = dacCode;
+			}
+		}
+	}
+	
+	return result;
+}
+
+//
+void	AD74413R_setOutputCurrentOnCh(uint8_t		API_ref,
+																		uint8_t		chId,
+																			float		mA)
+{
+	AD74413R_API	*pAPI;
+	uint16_t			dacCode = 0;
+	
+	if(mA >= CURRENT_OUTPUT_MIN && mA <= CURRENT_OUTPUT_MAX)
+	{
+		pAPI	= getPtrFromRef(API_ref);
+		
+		if(pAPI)
+		{
+			if(pAPI->chInfo[chId].chMode == AD74413R_CURRENT_OUTPUT)
+			{
+				dacCode = calcDacCodeForCurrent(mA);
+				
+				pAPI->chInfo[chId].ramp.active		=	false;
+				pAPI->chInfo[chId].piCtrl.enabled	=	false;
+				(void)writeOutputConfig(pAPI, chId,
+																pAPI->chInfo[chId].outputConfig
+																& ~(BITM_OUTPUT_CONFIG_SLEW_EN|BITM_OUTPUT_CONFIG_SLEW_LIN_STEP
+																		|BITM_OUTPUT_CONFIG_SLEW_LIN_RATE));
+				
+				if(SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+														dacCode,
+														true) == AD74413R_RESULT_OK)
+				{
+					pAPI->chInfo[chId].dacCode = dacCode;
+				}
+			}
+		}
+	}
+}
+
+
+// фильтр одиночных выбросов кодов АЦП канала
+AD74413R_RESULT	AD74413R_setSpikeFilter(uint8_t								API_ref,
+																				uint8_t								chId,
+																				AD74413R_FILTER_MODE	mode)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_ADC_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		pAPI->chInfo[chId].spikeFilter.fill	=	0;
+		pAPI->chInfo[chId].spikeFilter.pos	=	0;
+		pAPI->chInfo[chId].spikeFilter.mode	=	mode;
+		result = AD74413R_RESULT_OK;
+	}
+	
+	return result;
+}
+
+
+// окно допустимых значений канала в его единицах (В, мА, Ом или °C): ниже minVal -
+// обрыв, выше maxVal - короткое замыкание; при смене функции канала
+// окно сбрасывается к значению по умолчанию
+void	AD74413R_setFaultWindow(uint8_t	API_ref,
+															uint8_t	chId,
+															float		minVal,
+															float		maxVal,
+															bool		enable)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		pAPI->chInfo[chId].fault.minVal		=	minVal;
+		pAPI->chInfo[chId].fault.maxVal		=	maxVal;
+		pAPI->chInfo[chId].fault.windowEn	=	enable;
+	}
+}
+
+
+// сопротивление проводов канала измерения сопротивления, вычитается из результата
+// со следующего отсчёта
+void	AD74413R_setWireRes(uint8_t	API_ref,
+													uint8_t	chId,
+													float		wireRes)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		pAPI->chInfo[chId].wireRes	=	wireRes;
+	}
+}
+
+
+// тип термометра сопротивления: значение канала измерения сопротивления
+// выдаётся в °C; значение в новых единицах - со следующего отсчёта
+void	AD74413R_setRtdType(uint8_t							API_ref,
+													uint8_t							chId,
+													AD74413R_RTD_TYPE	rtdType)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS) && (rtdType <= AD74413R_RTD_NI120)
+			&& (pAPI->chInfo[chId].rtdType != rtdType))
+	{
+		pAPI->chInfo[chId].rtdType	=	rtdType;
+		pAPI->chInfo[chId].chVal		=	0.0f;
+		pAPI->chInfo[chId].valSeq		=	pAPI->chInfo[chId].codeSeq;
+	}
+}
+
+
+// тип термопары канала в режиме термопары: значение выдаётся в °C
+// с компенсацией холодного спая; значение в новых единицах - со следующего отсчёта
+void	AD74413R_setTcType(uint8_t						API_ref,
+												uint8_t						chId,
+												AD74413R_TC_TYPE	tcType)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS) && (tcType <= AD74413R_TC_T)
+			&& (pAPI->chInfo[chId].tcType != tcType))
+	{
+		pAPI->chInfo[chId].tcType	=	tcType;
+		pAPI->chInfo[chId].chVal	=	0.0f;
+		pAPI->chInfo[chId].valSeq	=	pAPI->chInfo[chId].codeSeq;
+	}
+}
+
+
+// температура холодного спая, используемая каналами термопар, °C;
+// false - температура номинальная или источник TEMPERATURE снят со слотов
+bool	AD74413R_getCjcTemperature(uint8_t	API_ref,
+																	float		*pCjcDeg)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(!pAPI || !pCjcDeg)
+		return false;
+	
+	*pCjcDeg = getCjcTemperature(pAPI);
+	
+	return (pAPI->diagRot.validMask & (1 << TEMPERATURE)) && isDiagScheduled(pAPI, TEMPERATURE);
+}
+
+
+// подтверждённое состояние неисправности канала
+AD74413R_FAULT_STATE	AD74413R_getFaultState(uint8_t	API_ref,
+																						uint8_t	chId)
+{
+	AD74413R_FAULT_STATE	state	=	AD74413R_FAULT_NONE;
+	AD74413R_API					*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		state = pAPI->chInfo[chId].fault.state;
+	}
+	
+	return state;
+}
+
+
+// количество подтверждённых неисправностей канала с момента инициализации
+uint32_t	AD74413R_getFaultCount(uint8_t	API_ref,
+																uint8_t	chId)
+{
+	uint32_t			count	=	0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		count = pAPI->chInfo[chId].fault.count;
+	}
+	
+	return count;
+}
+
+
+// количество отсчётов, отбракованных фильтром выбросов
+uint32_t	AD74413R_getRejectedCount(uint8_t	API_ref,
+																	uint8_t	chId)
+{
+	uint32_t			rejected	=	0;
+	AD74413R_API	*pAPI			=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		rejected = pAPI->chInfo[chId].spikeFilter.rejected;
+	}
+	
+	return rejected;
+}
+
+
+// плавный переход выхода к target (В для выхода напряжения, мА для выхода тока)
+// за rampMs: при возможности используется встроенное линейное нарастание ЦАП
+// (одна-две записи), иначе - программное нарастание из AD74413R_handler
+AD74413R_RESULT	AD74413R_rampOutputOnCh(uint8_t		API_ref,
+																				uint8_t		chId,
+																				float			target,
+																				uint32_t	rampMs)
+{
+	AD74413R_RESULT	result				=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI					=	getPtrFromRef(API_ref);
+	uint16_t				dacCode				=	0;
+	uint16_t				delta					=	0;
+	uint16_t				slewConfig		=	0;
+	uint16_t				outputConfig	=	0;
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		switch(pAPI->chInfo[chId].chMode)
+		{
+			case AD74413R_VOLTAGE_OUTPUT:
+				if(target < VOLTAGE_OUTPUT_MIN || target > VOLTAGE_OUTPUT_MAX)
+					return ad74413_RESULT_INVALID_REQUEST;
+				dacCode = calcDacCodeForVoltage(target);
+				break;
+			
+			case AD74413R_CURRENT_OUTPUT:
+				if(target < CURRENT_OUTPUT_MIN || target > CURRENT_OUTPUT_MAX)
+					return ad74413_RESULT_INVALID_REQUEST;
+				dacCode = calcDacCodeForCurrent(target);
+				break;
+			
+			default:
+				return ad74413_RESULT_WRONG_CHANNEL_ACTION_FOR_TYPE;
+		}
+		
+		pAPI->chInfo[chId].ramp.active		=	false;
+		pAPI->chInfo[chId].piCtrl.enabled	=	false;
+		
+		delta = (dacCode > pAPI->chInfo[chId].dacCode)?
+						(dacCode - pAPI->chInfo[chId].dacCode):(pAPI->chInfo[chId].dacCode - dacCode);
+		if((rampMs != 0) && (delta != 0))
+			slewConfig = selectSlew(delta, rampMs);
+		
+		outputConfig = (pAPI->chInfo[chId].outputConfig
+										& ~(BITM_OUTPUT_CONFIG_SLEW_EN|BITM_OUTPUT_CONFIG_SLEW_LIN_STEP
+												|BITM_OUTPUT_CONFIG_SLEW_LIN_RATE))
+									|slewConfig;
+		result = writeOutputConfig(pAPI, chId, outputConfig);
+		if(result != AD74413R_RESULT_OK)
+			return result;
+		
+		if((rampMs != 0) && (delta != 0) && (slewConfig == 0))
+		{
+			pAPI->chInfo[chId].ramp.startCode		=	pAPI->chInfo[chId].dacCode;
+			pAPI->chInfo[chId].ramp.targetCode	=	dacCode;
+			pAPI->chInfo[chId].ramp.startMs			=	msTicks;
+			pAPI->chInfo[chId].ramp.lastMs			=	msTicks;
+			pAPI->chInfo[chId].ramp.durationMs	=	rampMs;
+			pAPI->chInfo[chId].ramp.active			=	true;
+		}
+		else
+		{
+			// при включённом нарастании чип сам ведёт выход к записанному коду,
+			// проверка записи по DAC_CODE корректна, т.к. читается целевой код
+			result = SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
+																dacCode,
+																true);
+			if(result == AD74413R_RESULT_OK)
+				pAPI->chInfo[chId].dacCode = dacCode;
+		}
+	}
+	
+	return result;
+}
+
+
+//
+bool	AD74413R_isRampActive(uint8_t	API_ref,
+														uint8_t	chId)
+{
+	bool					active	=	false;
+	AD74413R_API	*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		active = pAPI->chInfo[chId].ramp.active;
+	}
+	
+	return active;
+}
+
+
+// безопасное значение выхода (В для выхода напряжения, мА для выхода тока),
+// загружаемое аппаратно по команде очистки ЦАП
+AD74413R_RESULT	AD74413R_setSafeState(uint8_t	API_ref,
+																			uint8_t	chId,
+																			float		safeVal,
+																			bool		enable)
+{
+	AD74413R_RESULT	result				=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI					=	getPtrFromRef(API_ref);
+	uint16_t				clrCode				=	0;
+	uint16_t				outputConfig	=	0;
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		switch(pAPI->chInfo[chId].chMode)
+		{
+			case AD74413R_VOLTAGE_OUTPUT:
+				if(safeVal < VOLTAGE_OUTPUT_MIN || safeVal > VOLTAGE_OUTPUT_MAX)
+					return ad74413_RESULT_INVALID_REQUEST;
+				clrCode = calcDacCodeForVoltage(safeVal);
+				break;
+			
+			case AD74413R_CURRENT_OUTPUT:
+				if(safeVal < CURRENT_OUTPUT_MIN || safeVal > CURRENT_OUTPUT_MAX)
+					return ad74413_RESULT_INVALID_REQUEST;
+				clrCode = calcDacCodeForCurrent(safeVal);
+				break;
+			
+			default:
+				return ad74413_RESULT_WRONG_CHANNEL_ACTION_FOR_TYPE;
+		}
+		
+		result = SPI_writeFrame32(pAPI, AD74413_REG_DAC_CLR_CODE0+chId,
+															clrCode,
+															true);
+		if(result != AD74413R_RESULT_OK)
+			return result;
+		pAPI->chInfo[chId].clrCode = clrCode;
+		
+		outputConfig = enable?
+										(pAPI->chInfo[chId].outputConfig | BITM_OUTPUT_CONFIG_CLR_EN):
+										(pAPI->chInfo[chId].outputConfig & ~BITM_OUTPUT_CONFIG_CLR_EN);
+		result = writeOutputConfig(pAPI, chId, outputConfig);
+	}
+	
+	return result;
+}
+
+
+// флаги ALERT_STATUS (BITM_ALERT_STATUS_x), при которых выходы
+// автоматически переводятся в безопасное состояние
+void	AD74413R_setSafeStateTrigger(uint8_t		API_ref,
+																	uint16_t	alertMask)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		pAPI->safeTriggerMask = alertMask;
+	}
+}
+
+
+// немедленный перевод выходов с разрешённой очисткой в безопасное состояние
+AD74413R_RESULT	AD74413R_triggerSafeState(uint8_t	API_ref)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		result = triggerDacClear(pAPI);
+	}
+	
+	return result;
+}
+
+
+// коэффициенты регулятора выхода; maxStep - наибольшее изменение кода ЦАП
+// за цикл (0 - без ограничения)
+AD74413R_RESULT	AD74413R_setRegulator(uint8_t		API_ref,
+																			uint8_t		chId,
+																			float			kp,
+																			float			ki,
+																			uint16_t	maxStep)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		pAPI->chInfo[chId].piCtrl.kp			=	kp;
+		pAPI->chInfo[chId].piCtrl.ki			=	ki;
+		pAPI->chInfo[chId].piCtrl.maxStep	=	maxStep;
+		result = AD74413R_RESULT_OK;
+	}
+	
+	return result;
+}
+
+
+// уставка регулятора: мА для выхода напряжения, В для выхода тока;
+// регулятор включается без скачка выхода с текущего кода ЦАП
+AD74413R_RESULT	AD74413R_setRegulatorSetpoint(uint8_t	API_ref,
+																							uint8_t	chId,
+																							float		setpoint)
+{
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
+	tPiCtrl					*pPi;
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		if((pAPI->chInfo[chId].chMode != AD74413R_VOLTAGE_OUTPUT)
+				&& (pAPI->chInfo[chId].chMode != AD74413R_CURRENT_OUTPUT))
+		{
+			return ad74413_RESULT_WRONG_CHANNEL_ACTION_FOR_TYPE;
+		}
+		
+		pPi = &pAPI->chInfo[chId].piCtrl;
+		pPi->setpoint = setpoint;
+		if(!pPi->enabled)
+		{
+			// безударное включение: первый выход регулятора равен текущему коду ЦАП
+			pAPI->chInfo[chId].ramp.active	=	false;
+			pPi->integ					=	pAPI->chInfo[chId].dacCode
+															- pPi->kp * (setpoint - getChVal(pAPI, chId));
+			pPi->lastMs					=	msTicks;
+			pPi->updatePending	=	false;
+			pPi->enabled				=	true;
+		}
+		result = AD74413R_RESULT_OK;
+	}
+	
+	return result;
+}
+
+
+// отключение регулятора, выход остаётся на последнем коде ЦАП
+void	AD74413R_stopRegulator(uint8_t	API_ref,
+														uint8_t	chId)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		pAPI->chInfo[chId].piCtrl.enabled = false;
+	}
+}
+
+
+//
+void	AD74413R_setDiagMode(uint8_t	API_ref,
+													uint8_t		diagId,
+						AD74413R_DIAGNOSTIC_MODE	diagMode)
+{
+	AD74413R_API	*pAPI	= getPtrFromRef(API_ref);
+	
+	if(pAPI && (diagId < AD74413R_NUMBER_OF_DIAGNOSTICS) && (diagMode != V_AVSS))
+	{
+		// слот с явно заданным источником выходит из ротации
+		pAPI->diagRot.slotMask &= ~(1 << diagId);
+		applyDiagMode(pAPI, diagId, diagMode);
+		dropUnscheduledSense(pAPI);
+	}
+}
+
+
+float	AD74413R_getChValue(uint8_t		API_ref,
+													uint8_t		chId)
+{
+	float	chValue	=	0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		chValue = getChVal(pAPI, chId);
+	}
+	
+	return chValue;
+}
+
+
+float	AD74413R_getDiagValue(uint8_t		API_ref,
+														uint8_t		diagId)
+{
+	float	diagValue	=	0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (diagId < AD74413R_NUMBER_OF_DIAGNOSTICS))
+	{
+		diagValue = getDiagVal(pAPI, diagId);
+	}
+	
+	return diagValue;
+}
+
+
+// применение профиля функций каналов и источников диагностики одним пакетом:
+// одна остановка АЦП, записи только изменившихся каналов и слотов без
+// проверки каждого кадра, затем проверка CH_FUNC_SETUP/ADC_CONFIG/DIN_CONFIG
+// одним чтением подряд и один перезапуск преобразований. Ротация диагностик
+// отключается - источники всех слотов задаются профилем
+AD74413R_RESULT	AD74413R_applyProfile(uint8_t						API_ref,
+																			const tChProfile	*pProfile)
+{
+	AD74413R_RESULT	result			=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI				=	getPtrFromRef(API_ref);
+	tRegister				regs[PROFILE_MAX_FRAMES];
+	uint16_t				readback[PROFILE_READBACK_COUNT];
+	uint16_t				expected[PROFILE_READBACK_COUNT];
+	uint16_t				checkMask		=	0;
+	uint8_t					count				=	0;
+	uint8_t					hizCount		=	0;
+	uint8_t					chMask			=	0;
+	uint8_t					diagMask		=	0;
+	uint16_t				diagAssign	=	0;
+	uint16_t				dinConfig		=	0;
+	uint8_t					idx					=	0;
+	AD74413R_CHANNEL_MODE			chMode;
+	AD74413R_DIAGNOSTIC_MODE	diagMode;
+	
+	if(!pAPI || !pProfile)
+		return result;
+	
+	// ротация профилем отключается, поэтому холодный спай термопар
+	// должен измеряться в одном из слотов профиля
+	if(!isProfileCjcScheduled(pProfile))
+		return ad74413_RESULT_INVALID_REQUEST;
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pProfile->diagMode[diagId] == V_AVSS)
+			return ad74413_RESULT_INVALID_REQUEST;
+	}
+	
+	pAPI->diagRot.slotMask	=	0;
+	diagAssign							=	pAPI->diagAssign;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(pProfile->chMode[chId] != pAPI->chInfo[chId].chMode)
+			chMask |= (1 << chId);
+	}
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(pProfile->diagMode[diagId] != pAPI->diagInfo[diagId].diagMode)
+			diagMask |= (1 << diagId);
+	}
+	if((chMask == 0) && (diagMask == 0))
+	{
+		dropUnscheduledSense(pAPI);
+		return AD74413R_RESULT_OK;
+	}
+	
+	regs[count].regAdr		=	AD74413_REG_ADC_CONV_CTRL;
+	regs[count++].regData	=	ENUM_ADC_CONV_CTRL_IDLE | pAPI->chUsage;
+	
+	// все меняющиеся каналы сначала переводятся в HIGH_IMP
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(!(chMask & (1 << chId)))
+			continue;
+		
+		regs[count].regAdr		=	AD74413_REG_DAC_CODE0+chId;
+		regs[count++].regData	=	0x0000;
+		regs[count].regAdr		=	AD74413_REG_CH_FUNC_SETUP0+chId;
+		regs[count++].regData	=	ENUM_CH_FUNC_SETUP_HIGH_IMP;
+	}
+	hizCount = count;
+	
+	for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+	{
+		if(!(chMask & (1 << chId)))
+			continue;
+		
+		chMode = pProfile->chMode[chId];
+		resetChState(pAPI, chId, chMode);
+		
+		if(chFuncSetup(chMode) != ENUM_CH_FUNC_SETUP_HIGH_IMP)
+		{
+			regs[count].regAdr		=	AD74413_REG_CH_FUNC_SETUP0+chId;
+			regs[count++].regData	=	chFuncSetup(chMode);
+		}
+		if(chDinConfig(pAPI, chId, chMode, &dinConfig))
+		{
+			regs[count].regAdr		=	AD74413_REG_DIN_CONFIG0+chId;
+			regs[count++].regData	=	dinConfig;
+		}
+		
+		setChState(pAPI, chId, isAdcMode(chMode));
+	}
+	
+	for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+	{
+		if(!(diagMask & (1 << diagId)))
+			continue;
+		
+		diagMode = pProfile->diagMode[diagId];
+		pAPI->diagInfo[diagId].diagMode	= diagMode;
+		pAPI->diagInfo[diagId].diagVal	= 0.0f;
+		pAPI->diagInfo[diagId].valSeq		= pAPI->diagInfo[diagId].codeSeq;
+		pAPI->diagInfo[diagId].settle		= AD74413R_DIAG_SETTLE_SAMPLES;
+		
+		if((diagMode == DIAG_OFF) || (diagMode > LVIN))
+		{
+			setDiagState(pAPI, diagId, false);
+		}
+		else
+		{
+			setDiagState(pAPI, diagId, true);
+			diagAssign = DIAG_ASSIGN_SET(diagAssign, diagId, diagMode);
+		}
+	}
+	if(diagAssign != pAPI->diagAssign)
+	{
+		regs[count].regAdr		=	AD74413_REG_DIAG_ASSIGN;
+		regs[count++].regData	=	diagAssign;
+	}
+	
+	// новая функция записывается не раньше, чем канал выдержан в HIGH_IMP
+	result = SPI_writeBatch(pAPI, regs, hizCount);
+	
+	if(result == AD74413R_RESULT_OK)
+	{
+		if(chMask)
+			waitUs(AD74413R_HIGH_IMP_SETTLE_US);
+		result = SPI_writeBatch(pAPI, &regs[hizCount], count - hizCount);
+	}
+	
+	if(result == AD74413R_RESULT_OK)
+		result = SPI_readBurst32(pAPI, PROFILE_READBACK_FIRST, PROFILE_READBACK_COUNT, readback);
+	
+	// сверяется последнее записанное значение каждого регистра
+	if(result == AD74413R_RESULT_OK)
+	{
+		for(uint8_t i = 0; i < count; i++)
+		{
+			if((regs[i].regAdr < PROFILE_READBACK_FIRST)
+					|| (regs[i].regAdr >= PROFILE_READBACK_FIRST + PROFILE_READBACK_COUNT))
+			{
+				continue;
+			}
+			idx							=	regs[i].regAdr - PROFILE_READBACK_FIRST;
+			expected[idx]		=	regs[i].regData;
+			checkMask				|=	(1 << idx);
+		}
+		for(idx = 0; idx < PROFILE_READBACK_COUNT; idx++)
+		{
+			if((checkMask & (1 << idx)) && (readback[idx] != expected[idx]))
+				result = AD74413R_RESULT_REG_WRONG_DATA_IS_WRITTEN;
+		}
+	}
+	
+	if((result == AD74413R_RESULT_OK) && (diagAssign != pAPI->diagAssign))
+	{
+		result = SPI_readFrame32(pAPI, AD74413_REG_DIAG_ASSIGN);
+		if((result == AD74413R_RESULT_OK) && (pAPI->spiInfo.rxData != diagAssign))
+			result = AD74413R_RESULT_REG_WRONG_DATA_IS_WRITTEN;
+		if(result == AD74413R_RESULT_OK)
+			pAPI->diagAssign = diagAssign;
+	}
+	
+	// ADC_CONFIG выставлен чипом под новую функцию и уже прочитан
+	if(result == AD74413R_RESULT_OK)
+	{
+		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
+		{
+			if((chMask & (1 << chId)) && isAdcMode(pProfile->chMode[chId]))
+			{
+				storeAdcConfig(pAPI, chId,
+												readback[AD74413_REG_ADC_CONFIG0 + chId - PROFILE_READBACK_FIRST]);
+			}
+		}
+	}
+	
+	dropUnscheduledSense(pAPI);
+	restartConversions(pAPI);
+	
+	return result;
+}
+
+
+// ротация источников диагностики через слоты slotMask: раз в periodMs
+// каждый слот получает следующий источник из srcMask (бит n - источник n);
+// источников не больше, чем слотов, - назначаются один раз без ротации
+void	AD74413R_setDiagRotation(uint8_t		API_ref,
+																uint8_t		slotMask,
+																uint16_t	srcMask,
+																uint32_t	periodMs)
+{
+	AD74413R_API	*pAPI			=	getPtrFromRef(API_ref);
+	uint8_t				srcCount	=	0;
+	uint8_t				slotCount	=	0;
+	
+	if(pAPI)
+	{
+		slotMask	&=	(1 << AD74413R_NUMBER_OF_DIAGNOSTICS) - 1;
+		srcMask		&=	~((1 << DIAG_OFF) | (1 << V_AVSS)) & ((1 << (LVIN+1)) - 1);
+		
+		for(uint8_t src = AGND; src <= LVIN; src++)
+		{
+			if(srcMask & (1 << src))
+				srcCount++;
+		}
+		
+		pAPI->diagRot.slotMask	=	0;
+		pAPI->diagRot.srcMask		=	srcMask;
+		pAPI->diagRot.periodMs	=	periodMs;
+		pAPI->diagRot.lastMs		=	msTicks;
+		pAPI->diagRot.next			=	AGND;
+		
+		for(uint8_t diagId = 0; diagId < AD74413R_NUMBER_OF_DIAGNOSTICS; diagId++)
+		{
+			if(!(slotMask & (1 << diagId)))
+				continue;
+			
+			// лишние слоты отключаются, чтобы не тратить на них время АЦП
+			if(slotCount < srcCount)
+			{
+				applyDiagMode(pAPI, diagId, nextDiagSource(pAPI));
+				pAPI->diagRot.slotMask |= (1 << diagId);
+				slotCount++;
+			}
+			else
+			{
+				applyDiagMode(pAPI, diagId, DIAG_OFF);
+			}
+		}
+		
+		if(srcCount <= slotCount)
+			pAPI->diagRot.slotMask = 0;
+		
+		dropUnscheduledSense(pAPI);
+	}
+}
+
+
+// последнее значение источника диагностики независимо от слота, 0 - источник ещё не измерялся
+float	AD74413R_getDiagSourceValue(uint8_t										API_ref,
+																	AD74413R_DIAGNOSTIC_MODE	diagSrc)
+{
+	float					diagValue	=	0;
+	AD74413R_API	*pAPI			=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (diagSrc <= LVIN) && (pAPI->diagRot.validMask & (1 << diagSrc)))
+	{
+		diagValue = calcDiagValue(diagSrc, pAPI->diagRot.srcCode[diagSrc]);
+	}
+	
+	return diagValue;
+}
+
+
+// настройка цифрового входа: время антидребезга (0..31), ток нагрузки (0..15)
+// и включение аппаратного счётчика импульсов
+AD74413R_RESULT	AD74413R_setDinConfig(uint8_t		API_ref,
+																			uint8_t		chId,
+																			uint8_t		debounceTime,
+																			uint8_t		sinkCurrent,
+																			bool			countEn)
+{
+	AD74413R_RESULT	result		=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI			=	getPtrFromRef(API_ref);
+	uint16_t				dinConfig	=	0;
+	
+	if(pAPI)
+	{
+		if(chId >= AD74413R_NUMBER_OF_CHANNELS)
+			return ad74413_RESULT_CHANNEL_ERROR;
+		
+		dinConfig = BITM_DIN_CONFIG_COMPARATOR_EN
+								|((debounceTime << BITP_DIN_CONFIG_DEBOUNCE_TIME) & BITM_DIN_CONFIG_DEBOUNCE_TIME)
+								|((sinkCurrent << BITP_DIN_CONFIG_DIN_SINK) & BITM_DIN_CONFIG_DIN_SINK)
+								|(countEn?BITM_DIN_CONFIG_COUNT_EN:0);
+		
+		result = SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
+															dinConfig,
+															true);
+		if(result == AD74413R_RESULT_OK)
+		{
+			pAPI->chInfo[chId].dinConfig		=	dinConfig;
+			pAPI->chInfo[chId].dinCnt.valid	=	false;
+		}
+	}
+	
+	return result;
+}
+
+
+// порог компаратора цифровых входов, общий для всех каналов чипа
+AD74413R_RESULT	AD74413R_setDinThreshold(uint8_t	API_ref,
+																				uint8_t		compThresh,
+																				bool			relToVref)
+{
+	AD74413R_RESULT	result		=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI			=	getPtrFromRef(API_ref);
+	uint16_t				dinThresh	=	0;
+	
+	if(pAPI)
+	{
+		dinThresh = ((compThresh << BITP_DIN_THRESH_COMP_THRESH) & BITM_DIN_THRESH_COMP_THRESH)
+								|(relToVref?ENUM_DIN_THRESH_REL_TO_VREF:ENUM_DIN_THRESH_REL_TO_AVDD);
+		
+		result = SPI_writeFrame32(pAPI, AD74413_REG_DIN_THRESH,
+															dinThresh,
+															true);
+		if(result == AD74413R_RESULT_OK)
+			pAPI->dinThresh = dinThresh;
+	}
+	
+	return result;
+}
+
+
+// количество импульсов, накопленное с момента выбора режима или последнего сброса
+uint32_t	AD74413R_getDinCount(uint8_t	API_ref,
+															uint8_t		chId)
+{
+	uint32_t			total	=	0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		total = pAPI->chInfo[chId].dinCnt.total;
+	}
+	
+	return total;
+}
+
+
+// частота импульсов (Гц) за последний период опроса счётчика
+float	AD74413R_getDinFrequency(uint8_t	API_ref,
+															uint8_t		chId)
+{
+	float					freq	=	0.0f;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		freq = pAPI->chInfo[chId].dinCnt.freq;
+	}
+	
+	return freq;
+}
+
+
+//
+void	AD74413R_clearDinCount(uint8_t	API_ref,
+														uint8_t		chId)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		pAPI->chInfo[chId].dinCnt.total = 0;
+	}
+}
+
+
+// проверка точности канала: эталонное значение и количество отсчётов (0 - без ограничения)
+void	AD74413R_setAccuracyTest(uint8_t		API_ref,
+															uint8_t		chId,
+															float			actualVal,
+															uint32_t	samples)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		pAPI->chInfo[chId].actualVal = actualVal;
+		AD74413R_statsInit(&pAPI->chInfo[chId].stats, samples);
+	}
+}
+
+
+// сброс статистики выполняется при следующем результате канала
+void	AD74413R_resetStats(uint8_t	API_ref,
+													uint8_t	chId)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		AD74413R_statsRequestReset(&pAPI->chInfo[chId].stats);
+	}
+}
+
+
+// гистограмма кодов АЦП: первая корзина от codeMin, ширина корзины 2^codeShift
+void	AD74413R_setStatsHistogram(uint8_t		API_ref,
+																uint8_t		chId,
+																uint16_t	codeMin,
+																uint8_t		codeShift)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		AD74413R_statsSetHistogram(&pAPI->chInfo[chId].stats, codeMin, codeShift);
+	}
+}
+
+
+// расчёт показателей точности по накопленной статистике
+bool	AD74413R_getAccuracy(uint8_t		API_ref,
+													uint8_t		chId,
+													tAccuracy	*pAccuracy)
+{
+	AD74413R_API	*pAPI		=	getPtrFromRef(API_ref);
+	tStats				*pStats	=	0;
+	float					mean		=	0.0f;
+	
+	if(!pAPI || !pAccuracy || (chId >= AD74413R_NUMBER_OF_CHANNELS))
+		return false;
+	
+	pStats = &pAPI->chInfo[chId].stats;
+	if((pStats->count == 0) || (pStats->resetAck != pStats->resetReq))
+		return false;
+	
+	mean = AD74413R_statsMean(pStats) + 0.5f;
+	
+	pAccuracy->actualVal		=	pAPI->chInfo[chId].actualVal;
+	pAccuracy->count				=	pStats->count;
+	pAccuracy->minVal				=	calcChValue(pAPI, chId, (uint16_t)pStats->min, pAPI->chInfo[chId].adcConfig);
+	pAccuracy->maxVal				=	calcChValue(pAPI, chId, (uint16_t)pStats->max, pAPI->chInfo[chId].adcConfig);
+	pAccuracy->averageVal		=	calcChValue(pAPI, chId, (mean < ADC_DIGIT)?(uint16_t)mean:0xFFFF,
+																						pAPI->chInfo[chId].adcConfig);
+	pAccuracy->codeVariance	=	AD74413R_statsVariance(pStats);
+	
+	pAccuracy->nDeviationPercentage	=	0.0f;
+	pAccuracy->pDeviationPercentage	=	0.0f;
+	if(pAccuracy->actualVal != 0.0f)
+	{
+		pAccuracy->nDeviationPercentage	=	(1 - pAccuracy->minVal / pAccuracy->actualVal) * 100.0f;
+		pAccuracy->pDeviationPercentage	=	(pAccuracy->maxVal / pAccuracy->actualVal - 1) * 100.0f;
+	}
+	
+	return true;
+}
+
+
+//
+const tStats	*AD74413R_getStats(uint8_t	API_ref,
+																	uint8_t	chId)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	return (pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))?(&pAPI->chInfo[chId].stats):0;
+}
+
+
+// длительность скользящего окна отсчётов канала (не более AD74413R_WINDOW_SIZE отсчётов)
+void	AD74413R_setWindow(uint8_t		API_ref,
+												uint8_t		chId,
+												uint32_t	windowMs)
+{
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
+	
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
+	{
+		AD74413R_windowInit(&pAPI->chInfo[chId].window, windowMs);
+	}
+}
+
+
+// минимум, максимум и среднее значения канала по скользящему окну; количество
+// отсчётов и фактический охват окна в мс показывают, покрыта ли заданная
+// длительность (при частых отсчётах окно ограничено ёмкостью AD74413R_WINDOW_SIZE)
+bool	AD74413R_getWindowValues(uint8_t	API_ref,
+															uint8_t	chId,
+															float		*pMin,
+															float		*pMax,
+															float		*pMean,
+															uint16_t	*pCount,
+															uint32_t	*pSpanMs)
+{
+	AD74413R_API	*pAPI			=	getPtrFromRef(API_ref);
+	tWindow				*pWindow	=	0;
+	float					minVal		=	0.0f;
+	float					maxVal		=	0.0f;
+	float					mean			=	0.0f;
+	
+	if(!pAPI || (chId >= AD74413R_NUMBER_OF_CHANNELS))
+		return false;
+	
+	pWindow = &pAPI->chInfo[chId].window;
+	if((AD74413R_windowCount(pWindow) == 0) || (pWindow->resetAck != pWindow->resetReq))
+		return false;
+	
+	minVal	=	calcChValue(pAPI, chId, AD74413R_windowMin(pWindow), pAPI->chInfo[chId].adcConfig);
+	maxVal	=	calcChValue(pAPI, chId, AD74413R_windowMax(pWindow), pAPI->chInfo[chId].adcConfig);
+	mean		=	AD74413R_windowMean(pWindow) + 0.5f;
+	
+	// пересчёт кода в значение может быть убывающим
+	if(pMin)
+		*pMin = (minVal < maxVal)?minVal:maxVal;
+	if(pMax)
+		*pMax = (minVal < maxVal)?maxVal:minVal;
+	if(pMean)
+		*pMean = calcChValue(pAPI, chId, (mean < ADC_DIGIT)?(uint16_t)mean:0xFFFF,
+															pAPI->chInfo[chId].adcConfig);
+	if(pCount)
+		*pCount = AD74413R_windowCount(pWindow);
+	if(pSpanMs)
+		*pSpanMs = AD74413R_windowSpanMs(pWindow);
+	
+	return true;
 }
 
 
-//
-void	AD74413R_init(uint8_t					API_ref,
-								MDR_SSP_TypeDef			*SSPx,
-								MDR_PORT_TypeDef*		csPORTx,
-								uint32_t						csPORT_Pin,
-								MDR_PORT_TypeDef*		rstPORTx,
-								uint32_t						rstPORT_Pin,
-								MDR_PORT_TypeDef*		adcRdyPORTx,
-								uint32_t						adcRdyPORT_Pin)
+// быстрый опрос цифровых входов: один кадр на чип,
+// допускается вызывать чаще, чем AD74413R_handler, но не из прерывания
+AD74413R_RESULT	AD74413R_snapshotDin(uint8_t	API_ref)
 {
-	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
 	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
 	
 	if(pAPI)
 	{
-		initialiseAPI(pAPI,	API_ref,
-									SSPx,	csPORTx,	csPORT_Pin,
-									rstPORTx,	rstPORT_Pin,
-									adcRdyPORTx,	adcRdyPORT_Pin);
-		
-		SPI_softwareReset(pAPI);
-		
-		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_ADC_CHANNELS; chId++)
-		{
-			result = SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONFIG0+chId,
-										ENUM_ADC_CONFIG_SPS_4K,
-										true);
-			result = SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
-										BITM_DIN_CONFIG_COMPARATOR_EN,
-										true);
-			result = SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
-										ENUM_GPO_CONFIG_SEL_GPDATA,
-										true);
-		}
+		result = readDinSnapshot(pAPI);
 	}
+	
+	return result;
 }
 
 
-//
-void	AD74413R_analyzeChipStatus(uint8_t	API_ref)
+// состояния компараторов из последнего снимка (бит n - канал n)
+uint8_t	AD74413R_getDinState(uint8_t	API_ref)
 {
-	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	uint8_t				state	=	0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
 	if(pAPI)
 	{
-		;
+		state = pAPI->dinSnap.state;
 	}
+	
+	return state;
 }
 
 
-//
-void	AD74413R_turnChipInWork(uint8_t	API_ref,
-																bool	inUse)
+// извлечение самого старого события изменения цифровых входов
+bool	AD74413R_popDinEvent(uint8_t		API_ref,
+													tDinEvent	*pEvent)
 {
-	AD74413R_API *pAPI = getPtrFromRef(API_ref);
+	bool					popped	=	false;
+	AD74413R_API	*pAPI		=	getPtrFromRef(API_ref);
 	
-	if(pAPI)
+	if(pAPI && pEvent)
 	{
-		//pAPI->inUse = inUse;
-		;
+		if(pAPI->dinSnap.tail != pAPI->dinSnap.head)
+		{
+			*pEvent = pAPI->dinSnap.queue[pAPI->dinSnap.tail];
+			pAPI->dinSnap.tail = (pAPI->dinSnap.tail + 1) % AD74413R_DIN_EVENT_QUEUE_SIZE;
+			popped = true;
+		}
 	}
+	
+	return popped;
 }
 
 
-//
-void	AD74413R_setRegData(uint8_t		API_ref,
-													uint8_t		nRegAdr,
-													uint16_t	nRegData,
-															bool	validate)
+void	AD74413R_setGPO(uint8_t	API_ref, uint8_t chId)
 {
-	//AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
-	AD74413R_API 	*pAPI 	= getPtrFromRef(API_ref);
+	AD74413R_API	*pAPI = getPtrFromRef(API_ref);
 	
-	if(pAPI)
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
 	{
-		(void)SPI_writeFrame32(pAPI, nRegAdr, nRegData, validate);
+		pAPI->chInfo[chId].gpoConfig = ENUM_GPO_CONFIG_SEL_GPDATA|(0x01 << 3);
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
+														pAPI->chInfo[chId].gpoConfig,
+														true);
 	}
 }
 
-//
-uint16_t	AD74413R_getRegData(uint8_t		API_ref,
-															uint8_t		nRegAdr)
+
+void	AD74413R_resetGPO(uint8_t	API_ref, uint8_t chId)
 {
-	uint16_t				data		=	0;
-	AD74413R_API 	*pAPI 	= getPtrFromRef(API_ref);
+	AD74413R_API	*pAPI = getPtrFromRef(API_ref);
 	
-	if(pAPI)
+	if(pAPI && (chId < AD74413R_NUMBER_OF_CHANNELS))
 	{
-		(void)SPI_readFrame32(pAPI, nRegAdr);
-		data = BA_getData(pAPI->spiInfo.frameBA);
+		pAPI->chInfo[chId].gpoConfig = ENUM_GPO_CONFIG_SEL_HIZ;
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
+														pAPI->chInfo[chId].gpoConfig,
+														true);
 	}
-	
-	return data;
 }
 
 
-//
-void	AD74413R_setChMode(uint8_t	API_ref,
-												uint8_t		chId,
-					AD74413R_CHANNEL_MODE		chMode)
+// перевод GPO каналов из chMask (бит n - канал n) в режим параллельных данных,
+// остальные параллельные GPO возвращаются в режим GPO_DATA с низким уровнем
+AD74413R_RESULT	AD74413R_setGpoParallelMode(uint8_t	API_ref,
+																						uint8_t	chMask)
 {
-	AD74413R_API	*pAPI	= getPtrFromRef(API_ref);
-	
-	pAPI->chInfo[chId].chMode = chMode;
+	AD74413R_RESULT	result		=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI			=	getPtrFromRef(API_ref);
+	uint16_t				gpoConfig	=	0;
 	
 	if(pAPI)
 	{
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
-														ENUM_ADC_CONV_CTRL_IDLE
-														|pAPI->chUsage,
-														true);
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
-														0x0000,
-														true);
-		(void)SPI_writeFrame32(pAPI, (AD74413_REG_CH_FUNC_SETUP0+chId),
-														ENUM_CH_FUNC_SETUP_HIGH_IMP,
-														true);
+		result = AD74413R_RESULT_OK;
 		
-		switch(chMode)
+		for(uint8_t chId = 0; chId < AD74413R_NUMBER_OF_CHANNELS; chId++)
 		{
-			case AD74413R_CHANNEL_OFF:			
-			case AD74413R_HIGH_IMPEDANCE:
-				setChState(pAPI, chId, false);
-				if(pAPI->chUsage == 0)
-				{
-					(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
-																	ENUM_ADC_CONV_CTRL_ADC_PWRDWN,
-																	true);
-				}
-				break;
-			
-			case AD74413R_VOLTAGE_OUTPUT:
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
-																ENUM_CH_FUNC_SETUP_VOUT,
-																true);
-				setChState(pAPI, chId, true);
-				break;
-			
-			case AD74413R_CURRENT_OUTPUT:
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
-																ENUM_CH_FUNC_SETUP_IOUT,
-																true);
-				setChState(pAPI, chId, true);
-				break;
-				
-			case AD74413R_CURRENT_MEASUREMENT:
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
-																ENUM_CH_FUNC_SETUP_IIN_EXT_PWR,
-																true);
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
-																BITM_DIN_CONFIG_COMPARATOR_EN,
-																true);
-				setChState(pAPI, chId, true);
-				break;
+			if(chMask & (1 << chId))
+				gpoConfig = ENUM_GPO_CONFIG_SEL_GPDATA_PAR;
+			else if(pAPI->chInfo[chId].gpoConfig == ENUM_GPO_CONFIG_SEL_GPDATA_PAR)
+				gpoConfig = ENUM_GPO_CONFIG_SEL_GPDATA;
+			else
+				continue;
 			
-			case AD74413R_VOLTAGE_MEASUREMENT:
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
-																ENUM_CH_FUNC_SETUP_VIN,
-																true);
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
-																BITM_DIN_CONFIG_COMPARATOR_EN,
-																true);
-				setChState(pAPI, chId, true);
-				break;
+			if(pAPI->chInfo[chId].gpoConfig == gpoConfig)
+				continue;
 			
-			case AD74413R_RESISTANCE_MEASUREMENT:
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_CH_FUNC_SETUP0+chId,
-																ENUM_CH_FUNC_SETUP_RES_MEAS,
-																true);
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DIN_CONFIG0+chId,
-																BITM_DIN_CONFIG_COMPARATOR_EN,
-																true);
-				setChState(pAPI, chId, true);
-				break;
-				
-			default:
-				setChState(pAPI, chId, false);
-				break;
+			if(SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
+													gpoConfig,
+													true) == AD74413R_RESULT_OK)
+			{
+				pAPI->chInfo[chId].gpoConfig = gpoConfig;
+			}
+			else
+			{
+				result = AD74413R_RESULT_REG_WRONG_DATA_IS_WRITTEN;
+			}
 		}
-		
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
-													ENUM_ADC_CONV_CTRL_CONTINUOUS
-													|pAPI->chUsage,
-													true);
 	}
+	
+	return result;
 }
 
 
-//
-AD74413R_RESULT	AD74413R_setOutputVoltageOnCh(uint8_t		API_ref,
-																							uint8_t		chId,
-																							float			volt)
+// одновременная установка уровней всех параллельных GPO одним кадром
+// (бит n - канал n), запись без проверки чтением
+AD74413R_RESULT	AD74413R_writeGpoParallel(uint8_t	API_ref,
+																					uint8_t	levelMask)
 {
-	AD74413R_RESULT	result	=	AD74413R_RESULT_OK;
-	AD74413R_API		*pAPI		=	NULL;
-	uint16_t				dacCode = 0;
+	AD74413R_RESULT	result	=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI		=	getPtrFromRef(API_ref);
 	
-	if(volt >= VOLTAGE_OUTPUT_MIN && volt <= VOLTAGE_OUTPUT_MAX)
+	if(pAPI)
 	{
-		pAPI	= getPtrFromRef(API_ref);
+		levelMask &= BITM_GPO_PARALLEL_GPO_PAR_DATA_A|BITM_GPO_PARALLEL_GPO_PAR_DATA_B
+								|BITM_GPO_PARALLEL_GPO_PAR_DATA_C|BITM_GPO_PARALLEL_GPO_PAR_DATA_D;
 		
-		if(pAPI)
-		{
-			if(pAPI->chInfo[chId].chMode == AD74413R_VOLTAGE_OUTPUT)
-			{
-				dacCode = calcDacCodeForVoltage(volt);
-				
-				result = SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
-																	dacCode,
-																	true);
-			}
-		}
+		result = SPI_writeFrame32(pAPI, AD74413_REG_GPO_PARALLEL,
+															levelMask,
+															false);
+		if(result == AD74413R_RESULT_OK)
+			pAPI->gpoParallel = levelMask;
 	}
 	
 	return result;
 }
 
-//
-void	AD74413R_setOutputCurrentOnCh(uint8_t		API_ref,
-																		uint8_t		chId,
-																			float		mA)
+
+// период опроса чипа в AD74413R_handler, 0 - при каждом вызове
+void	AD74413R_setRefreshPeriod(uint8_t		API_ref,
+																uint32_t	refreshMs)
 {
-	AD74413R_API	*pAPI;
-	uint16_t			dacCode = 0;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
-	if(mA >= CURRENT_OUTPUT_MIN && mA <= CURRENT_OUTPUT_MAX)
+	if(pAPI)
 	{
-		pAPI	= getPtrFromRef(API_ref);
-		
-		if(pAPI)
-		{
-			if(pAPI->chInfo[chId].chMode == AD74413R_CURRENT_OUTPUT)
-			{
-				dacCode = calcDacCodeForCurrent(mA);
-				
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DAC_CODE0+chId,
-																dacCode,
-																true);
-			}
-		}
+		pAPI->refreshMs = refreshMs;
 	}
 }
 
 
-//
-void	AD74413R_setDiagMode(uint8_t	API_ref,
-													uint8_t		diagId,
-						AD74413R_DIAGNOSTIC_MODE	diagMode)
+// период преобразования канала в последовательностях АЦП:
+// 1 - в каждой последовательности, N - в каждой N-й
+void	AD74413R_setChSeqPeriod(uint8_t	API_ref,
+															uint8_t	chId,
+															uint8_t	period)
 {
-	AD74413R_API	*pAPI	= getPtrFromRef(API_ref);
-	
-	pAPI->diagInfo[diagId].diagMode = diagMode;
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
-	if(pAPI)
-	{				
-		switch(diagMode)
-		{
-			case DIAG_OFF:
-				setDiagState(pAPI, diagId, false);
-				if(pAPI->chUsage == 0)
-				{
-					(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
-																	ENUM_ADC_CONV_CTRL_ADC_PWRDWN,
-																	true);
-				}
-				break;
-				
-			case TEMPERATURE:
-				setDiagState(pAPI, diagId, true);
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DIAG_ASSIGN,
-																(ENUM_DIAG0_ASSIGN_TEMP << (diagId*15)),
-																true);
-				break;
-				
-			case ALDO5V:
-				setDiagState(pAPI, diagId, true);
-				(void)SPI_writeFrame32(pAPI, AD74413_REG_DIAG_ASSIGN,
-																(ENUM_DIAG0_ASSIGN_ALDO5V << (diagId*15)),
-																true);
-				break;
-				
-			default:
-				setDiagState(pAPI, diagId, false);
-				break;
-		}
-				
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
-													ENUM_ADC_CONV_CTRL_CONTINUOUS
-													|pAPI->chUsage,
-													true);
+	if(pAPI && (chId < AD74413R_NUMBER_OF_ADC_CHANNELS))
+	{
+		setSeqPeriod(pAPI, chId, period);
 	}
 }
 
 
-float	AD74413R_getChValue(uint8_t		API_ref,
-													uint8_t		chId)
+// период преобразования диагностики в последовательностях АЦП
+void	AD74413R_setDiagSeqPeriod(uint8_t	API_ref,
+																uint8_t	diagId,
+																uint8_t	period)
 {
-	float	chValue	=	0;
 	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
-	if(pAPI)
+	if(pAPI && (diagId < AD74413R_NUMBER_OF_DIAGNOSTICS))
 	{
-		chValue = pAPI->chInfo[chId].chVal;
+		setSeqPeriod(pAPI, AD74413R_NUMBER_OF_ADC_CHANNELS+diagId, period);
 	}
-	
-	return chValue;
 }
 
 
-float	AD74413R_getDiagValue(uint8_t		API_ref,
-														uint8_t		diagId)
+// режим преобразований только по запросу: АЦП не ведёт непрерывных
+// преобразований, обработчик не читает результаты
+void	AD74413R_setOnDemandMode(uint8_t	API_ref,
+															bool		enable)
 {
-	float	diagValue	=	0;
 	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
-	if(pAPI)
+	if(pAPI && (pAPI->seqCtrl.onDemand != enable))
 	{
-		diagValue = pAPI->diagInfo[diagId].diagVal;
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+													ENUM_ADC_CONV_CTRL_IDLE
+													|pAPI->chUsage,
+													true);
+		pAPI->seqCtrl.onDemand = enable;
+		restartConversions(pAPI);
 	}
-	
-	return diagValue;
 }
 
 
-void	AD74413R_setGPO(uint8_t	API_ref, uint8_t chId)
+// одиночное преобразование слотов slotMask (биты ADC_CONV_CTRL: каналы A..D,
+// диагностики 0..3) с ожиданием готовности и чтением результатов подряд.
+// pCodes (AD74413R_NUMBER_OF_SEQ_SLOTS элементов) - коды по номеру слота,
+// pLatencyUs - время от запуска до получения данных; значения каналов и
+// диагностик пересчитываются сразу. Непрерывный режим после вызова возобновляется
+AD74413R_RESULT	AD74413R_convertOnce(uint8_t		API_ref,
+																		uint8_t		slotMask,
+																		uint16_t	*pCodes,
+																		uint32_t	*pLatencyUs)
 {
-	AD74413R_API	*pAPI = getPtrFromRef(API_ref);
+	AD74413R_RESULT	result		=	ad74413_RESULT_UNKNOWN_CHIP;
+	AD74413R_API		*pAPI			=	getPtrFromRef(API_ref);
+	uint16_t				codes[AD74413R_NUMBER_OF_SEQ_SLOTS];
+	uint8_t					first			=	0;
+	uint8_t					last			=	0;
+	uint16_t				lastTick	=	0;
+	uint32_t				latencyUs	=	0;
 	
 	if(pAPI)
 	{
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
-														ENUM_GPO_CONFIG_SEL_GPDATA
-														|(0x01 << 3),
-														true);
+		if(pAPI->chipState != CHIP_IN_WORK)
+			return ad74413_RESULT_INACTIVE_CHIP;
+		
+		// преобразуются только слоты с настроенной функцией
+		slotMask &= pAPI->chUsage;
+		if(slotMask == 0)
+			return ad74413_RESULT_INVALID_REQUEST;
+		
+		while(!(slotMask & (1 << first)))
+			first++;
+		last = AD74413R_NUMBER_OF_SEQ_SLOTS - 1;
+		while(!(slotMask & (1 << last)))
+			last--;
+		
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+													ENUM_ADC_CONV_CTRL_IDLE
+													|pAPI->chUsage,
+													true);
+		(void)SPI_writeFrame32(pAPI, AD74413_REG_LIVE_STATUS,
+													BITM_LIVE_STATUS_ADC_DATA_RDY,
+													false);
+		
+		lastTick = TIMEOUT_TIMER->CNT;
+		result = SPI_writeFrame32(pAPI, AD74413_REG_ADC_CONV_CTRL,
+															ENUM_ADC_CONV_CTRL_SINGLE
+															|slotMask,
+															false);
+		latencyUs += elapsedUs(&lastTick);
+		
+		if(result == AD74413R_RESULT_OK)
+			result = waitAdcReady(pAPI, &latencyUs);
+		
+		// результаты каналов и диагностик занимают подряд идущие регистры
+		if(result == AD74413R_RESULT_OK)
+		{
+			lastTick = TIMEOUT_TIMER->CNT;
+			result = SPI_readBurst32(pAPI, AD74413_REG_ADC_RESULT0+first,
+																last-first+1,
+																&codes[first]);
+			latencyUs += elapsedUs(&lastTick);
+		}
+		
+		if(result == AD74413R_RESULT_OK)
+		{
+			for(uint8_t slot = first; slot <= last; slot++)
+			{
+				if(!(slotMask & (1 << slot)))
+					continue;
+				
+				if(slot < AD74413R_NUMBER_OF_ADC_CHANNELS)
+					pAPI->chInfo[slot].adcCode = codes[slot];
+				else
+					pAPI->diagInfo[slot-AD74413R_NUMBER_OF_ADC_CHANNELS].diagCode = codes[slot];
+				pAPI->freshMask |= (1 << slot);
+				
+				if(pCodes)
+					pCodes[slot] = codes[slot];
+			}
+			
+			calcAdcRes(pAPI);
+			calcDiagRes(pAPI);
+		}
+		
+		if(pLatencyUs)
+			*pLatencyUs = latencyUs;
+		
+		restartConversions(pAPI);
 	}
+	
+	return result;
 }
 
 
-void	AD74413R_resetGPO(uint8_t	API_ref, uint8_t chId)
+// ленивый пересчёт: обработчик сохраняет только коды, значения каналов
+// и диагностик считаются при первом запросе после нового отсчёта
+void	AD74413R_setLazyValues(uint8_t	API_ref,
+															bool		enable)
 {
-	AD74413R_API	*pAPI = getPtrFromRef(API_ref);
+	AD74413R_API	*pAPI	=	getPtrFromRef(API_ref);
 	
 	if(pAPI)
 	{
-		(void)SPI_writeFrame32(pAPI, AD74413_REG_GPO_CONFIG0+chId,
-														ENUM_GPO_CONFIG_SEL_HIZ,
-														true);
+		pAPI->lazyValues = enable;
 	}
 }
 
 
-//
+// вызывается из прерывания системного таймера раз в 1 мс
+void	AD74413R_tick1ms(void)
+{
+	msTicks++;
+}
+
+
+// опрос чипов: обмен по SPI с чипом N+1 совмещается с расчётами чипа N
+// (выполняются во время ожидания CS), запись по результатам расчётов -
+// отдельным проходом после расчётов всех чипов
 void	AD74413R_handler(void)
 {
 	AD74413R_API	*pAPI;
+	uint32_t			now														=	msTicks;
+	bool					refreshed[MAX_SUPPORTED_AD74413R]	=	{false};
 	
 	for(uint8_t apiRefNum = 0; apiRefNum < MAX_SUPPORTED_AD74413R; apiRefNum++)
 	{
 			pAPI	= getPtrFromRef(apiRefNum+1);
-			if(pAPI)
+			// отсутствующие и спящие чипы не создают обмена по шине
+			if(!pAPI || (pAPI->chipState != CHIP_IN_WORK))
+				continue;
+			if((pAPI->refreshMs != 0) && ((now - pAPI->lastRefreshMs) < pAPI->refreshMs))
+				continue;
+			pAPI->lastRefreshMs = now;
+			
+			checkAlert(pAPI);
+			(void)checkRecovery(pAPI);
+			checkAdcDiag(pAPI);
+			checkDinCounters(pAPI);
+			
+			runPendingCalc();
+			pCalcPending = pAPI;
+			refreshed[apiRefNum] = true;
+	}
+	runPendingCalc();
+	
+	for(uint8_t apiRefNum = 0; apiRefNum < MAX_SUPPORTED_AD74413R; apiRefNum++)
+	{
+			if(refreshed[apiRefNum])
 			{
-				checkAlert(pAPI);
-				checkAdcDiag(pAPI);
-				calcAdcRes(pAPI);
-				calcDiagRes(pAPI);
+				pAPI	= getPtrFromRef(apiRefNum+1);
+				applyAutoRange(pAPI);
+				applyRamps(pAPI);
+				applyRegulators(pAPI);
+				applyDiagRotation(pAPI);
 			}
 	}
 }
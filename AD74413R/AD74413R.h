@@ -4,6 +4,9 @@
 
 	// подключение заголовочных файлов модулей проекта
 	#include "link.h"
+	#include "AD74413R_frame.h"
+	#include "AD74413R_stats.h"
+	#include "AD74413R_lin.h"
 	
 	
 	/* ==================== || =================================== || ==================== */
@@ -661,11 +664,37 @@
 	
 	#define AD74413R_SPI											MDR_SSP1
 	
+	// частота счёта TIMEOUT_TIMER->CNT (после предделителя), Гц; задаётся
+	// проектом под настройку таймера, должна быть кратна 1 МГц
+	#ifndef AD74413R_TIMER_CLOCK_HZ
+	#define AD74413R_TIMER_CLOCK_HZ						1000000UL
+	#endif
+	#define AD74413R_TIMER_TICKS_PER_US				(AD74413R_TIMER_CLOCK_HZ / 1000000UL)
+	#if (AD74413R_TIMER_TICKS_PER_US < 1)
+	#error "AD74413R_TIMER_CLOCK_HZ меньше 1 МГц"
+	#endif
+	
+	// время установки CS через расширитель, мкс;
+	// в это время выполняются расчёты предыдущего чипа
+	#ifndef AD74413R_CS_SETTLE_US
+	#define AD74413R_CS_SETTLE_US							1000
+	#endif
+	#define AD74413R_CS_SETTLE_TICKS					(AD74413R_CS_SETTLE_US * AD74413R_TIMER_TICKS_PER_US)
+	#if (AD74413R_CS_SETTLE_TICKS > 0xFFFF)
+	#error "AD74413R_CS_SETTLE_US больше периода 16-битного TIMEOUT_TIMER"
+	#endif
+	
 	#define AD74413R_NUMBER_OF_ADC_CHANNELS		4
 	#define AD74413R_NUMBER_OF_DIAGNOSTICS		4
 	#define AD74413R_NUMBER_OF_CHANNELS				4
+	// слоты последовательности АЦП в порядке битов ADC_CONV_CTRL: каналы A..D, диагностики 0..3
+	#define AD74413R_NUMBER_OF_SEQ_SLOTS			(AD74413R_NUMBER_OF_ADC_CHANNELS+AD74413R_NUMBER_OF_DIAGNOSTICS)
 	#define AD74413R_MAX_NUM_REGS_TO_READ			0
+	#define AD74413R_MAX_ALERT_HANDLERS				4
 	
+	// состояния чипа: UNUSED - не инициализирован или не отвечает, IN_USE - идёт
+	// настройка, IN_WORK - обслуживается обработчиком, IN_SLEEP - АЦП выключен,
+	// обработчик чип не опрашивает
 	#define CHIP_IN_USE				0x01
 	#define CHIP_UNUSED				0x00
 	#define CHIP_IN_WORK			0x02
@@ -679,12 +708,18 @@
 	#define CURRENT_OUTPUT_MAX				25.0f
 	#define CURRENT_DAC_CODE_FOR_1MA	327.64f
 	
+	#define DAC_CODE_MAX							0x1FFF
+	
+	#define AD74413R_SLEW_TOLERANCE		0.25f
+	#define AD74413R_RAMP_PERIOD_MS		5
+	
 	#define ADC_DIGIT							65535.0f
 	#define R_SENSE								100.0f
 	#define R_PULL_UP							2100.0f
 		
 	#define V_MIN_0V							0.0f
 	#define V_MIN_M2P5V						-2.5f
+	#define V_MIN_M0P104V					-0.10416f
 	
 	#define V_MAX_0								0.0f
 	#define V_MAX_2P5V						2.5f
@@ -694,6 +729,31 @@
 	#define V_RNG_0_2P5V					2.5f
 	#define V_RNG_M2P5V_0V				2.5f
 	#define V_RNG_M2P5V_2P5V			5.0f
+	#define V_RNG_M0P104V_0P104V	0.20832f
+	#define UV_MIN_M0P104V				-104160
+	#define UV_RNG_M0P104V_0P104V	208320
+	
+	#define AD74413R_DEFAULT_ADC_RATE					ENUM_ADC_CONFIG_SPS_4K
+	#define AD74413R_RESET_POLL_ATTEMPTS			10
+	#define AD74413R_PROBE_PATTERN						0xA55A
+	#define AD74413R_AUTORANGE_MARGIN					0.9f
+	#define AD74413R_AUTORANGE_SAT_CODE				0x00FF
+	#define AD74413R_AUTORANGE_SETTLE_SAMPLES	2
+	#define AD74413R_DIAG_SETTLE_SAMPLES			2
+	#define AD74413R_FAULT_CONFIRM_SAMPLES		3
+	#define AD74413R_FAULT_IIN_OPEN_MA				3.6f
+	#define AD74413R_FAULT_IIN_SHORT_MA				21.0f
+	#define AD74413R_FAULT_RES_SHORT_OHM			5.0f
+	#define AD74413R_FAULT_SENSE_TOLERANCE		0.5f
+	#define AD74413R_SINGLE_TIMEOUT_US				500000
+	#define AD74413R_HIGH_IMP_SETTLE_US				130
+	#define AD74413R_DAC_SETTLE_US						150
+	#define AD74413R_CJC_DEFAULT_DEG					25.0f
+	#define AD74413R_DIN_COUNTER_PERIOD_MS		100
+	#define AD74413R_SPIKE_WINDOW							5
+	#define AD74413R_SPIKE_MIN_DEV						16
+	#define AD74413R_HAMPEL_K									3
+	#define AD74413R_DIN_EVENT_QUEUE_SIZE			16
 	
 	
 	typedef enum
@@ -733,7 +793,10 @@
 		AD74413R_CURRENT_OUTPUT,
 		AD74413R_VOLTAGE_MEASUREMENT,
 		AD74413R_CURRENT_MEASUREMENT,
-		AD74413R_RESISTANCE_MEASUREMENT
+		AD74413R_RESISTANCE_MEASUREMENT,
+		AD74413R_DIGITAL_INPUT_LOGIC,
+		AD74413R_DIGITAL_INPUT_LOOP,
+		AD74413R_THERMOCOUPLE_MEASUREMENT
 	}AD74413R_CHANNEL_MODE;
 	
 	typedef enum
@@ -742,7 +805,7 @@
 		AGND,
 		TEMPERATURE,
 		AVDD,
-		V_AVSS,
+		V_AVSS,		// не поддерживается: пересчёт AVSS требует смещения, назначение отклоняется
 		REFOUT,
 		ALDO5V,
 		ALDO1V8,
@@ -756,12 +819,28 @@
 		LVIN		
 	}AD74413R_DIAGNOSTIC_MODE;
 	
+	typedef enum
+	{
+		AD74413R_FILTER_OFF = 0,
+		AD74413R_FILTER_MEDIAN3,
+		AD74413R_FILTER_MEDIAN5,
+		AD74413R_FILTER_HAMPEL5
+	}AD74413R_FILTER_MODE;
+	
+	typedef enum
+	{
+		AD74413R_FAULT_NONE = 0,
+		AD74413R_FAULT_OPEN_WIRE,
+		AD74413R_FAULT_SHORT_CIRCUIT,
+		AD74413R_FAULT_VI_ERROR
+	}AD74413R_FAULT_STATE;
+	
 	typedef struct
 	{
 		MDR_SSP_TypeDef			*SSPx;
 		MDR_PORT_TypeDef*		csPORTx;
 		uint32_t						csPORT_Pin;
-		uint8_t							frameBA[4];
+		uint16_t						rxData;
 	}tSpiInfo;
 	
 	typedef struct
@@ -774,31 +853,121 @@
 	
 	typedef struct
 	{
-		uint8_t		regAdr;
-		uint16_t	regData;
-	}tRegister;
-	
-	typedef struct
-	{
-		bool			reload;
 		float			actualVal;
-		uint16_t	averageCounts;
-		uint16_t	averageCounter;
+		uint32_t	count;
 		float			minVal;
 		float			nDeviationPercentage;
 		float			averageVal;
 		float			maxVal;
 		float			pDeviationPercentage;
+		float			codeVariance;
 	}tAccuracy;
 	
+	typedef struct
+	{
+		bool			valid;
+		uint16_t	lastCnt;
+		uint32_t	lastMs;
+		uint32_t	total;
+		float			freq;
+	}tDinCounter;
+	
+	typedef struct
+	{
+		uint32_t	ms;
+		uint8_t		state;
+		uint8_t		rising;
+		uint8_t		falling;
+	}tDinEvent;
+	
+	typedef struct
+	{
+		bool							valid;
+		uint8_t						state;
+		uint8_t						rising;
+		uint8_t						falling;
+		tDinEvent					queue[AD74413R_DIN_EVENT_QUEUE_SIZE];
+		volatile uint8_t	head;
+		volatile uint8_t	tail;
+		uint16_t					overflows;
+	}tDinSnapshot;
+	
+	typedef struct
+	{
+		bool			active;
+		uint16_t	startCode;
+		uint16_t	targetCode;
+		uint32_t	startMs;
+		uint32_t	durationMs;
+		uint32_t	lastMs;
+	}tDacRamp;
+	
+	typedef struct
+	{
+		bool			enabled;
+		float			setpoint;
+		float			kp;
+		float			ki;
+		float			integ;
+		uint16_t	maxStep;
+		uint32_t	lastMs;
+		bool			updatePending;
+		uint16_t	dacReq;
+	}tPiCtrl;
+	
+	typedef struct
+	{
+		AD74413R_FILTER_MODE	mode;
+		uint16_t	hist[AD74413R_SPIKE_WINDOW];
+		uint8_t		fill;
+		uint8_t		pos;
+		uint32_t	rejected;
+	}tSpikeFilter;
+	
+	typedef struct
+	{
+		AD74413R_FAULT_STATE	state;
+		AD74413R_FAULT_STATE	cand;
+		uint8_t		confirm;
+		bool			senseErr;
+		bool			windowEn;
+		float			minVal;
+		float			maxVal;
+		uint32_t	count;
+	}tChFault;
+	
 	typedef struct
 	{
 		AD74413R_CHANNEL_MODE	chMode;
+		uint16_t	adcConfig;
+		bool			userRange;
+		bool			autoRange;
+		bool			rangeReqPending;
+		uint16_t	rangeReq;
+		uint8_t		rangeSettle;
+		uint16_t	dacCode;
+		uint16_t	outputConfig;
+		uint16_t	clrCode;
+		tDacRamp	ramp;
+		tPiCtrl		piCtrl;
+		uint16_t	gpoConfig;
+		uint16_t	dinConfig;
+		tDinCounter	dinCnt;
 		uint16_t	adcCode;
+		tSpikeFilter	spikeFilter;
+		tChFault	fault;
+		uint16_t	valCode;				// отфильтрованный код последнего отсчёта
+		uint16_t	valAdcConfig;		// ADC_CONFIG, при котором получен отсчёт
+		uint16_t	codeSeq;				// номер последнего отсчёта
+		uint16_t	valSeq;					// номер отсчёта, по которому посчитан chVal
 		float			chVal;
 		float			wireRes;
+		AD74413R_RTD_TYPE	rtdType;	// линеаризация термометра сопротивления, значение в °C
+		AD74413R_TC_TYPE	tcType;		// линеаризация термопары, значение в °C
 		
-		tAccuracy	accuracy;
+		tStats		stats;
+		tWindow		window;
+		float			actualVal;
 	}tChannelInfo;
 	
 	typedef struct
@@ -806,8 +975,31 @@
 		AD74413R_DIAGNOSTIC_MODE	diagMode;
 		uint16_t	diagCode;
 		float			diagVal;
+		uint8_t		settle;
+		AD74413R_DIAGNOSTIC_MODE	valMode;
+		uint16_t	valCode;
+		uint16_t	codeSeq;
+		uint16_t	valSeq;
 	}tDiagnosticInfo;
 	
+	typedef struct
+	{
+		AD74413R_CHANNEL_MODE			chMode[AD74413R_NUMBER_OF_CHANNELS];
+		AD74413R_DIAGNOSTIC_MODE	diagMode[AD74413R_NUMBER_OF_DIAGNOSTICS];
+	}tChProfile;
+	
+	typedef struct
+	{
+		uint8_t		slotMask;						///< Слоты DIAG, отданные под ротацию
+		uint16_t	srcMask;						///< Источники (бит n - AD74413R_DIAGNOSTIC_MODE n)
+		uint32_t	periodMs;						///< Период смены источников, мс
+		uint32_t	lastMs;							///< Время последней смены
+		uint8_t		next;								///< Следующий источник для назначения
+		uint16_t	validMask;					///< Источники, для которых есть результат
+		uint16_t	freshMask;					///< Источники с результатом, ещё не учтённым детектором неисправностей
+		uint16_t	srcCode[LVIN+1];		///< Последние коды источников
+	}tDiagRotation;
+	
 	typedef struct
 	{
 		uint16_t	VI_ERR_A					:		1;
@@ -828,6 +1020,52 @@
 		uint16_t	RESET_OCCURRED		:		1;
 	}tAlertInfo;
 	
+	typedef struct
+	{
+		uint16_t	VI_ERR_CURR_A				:		1;
+		uint16_t	VI_ERR_CURR_B				:		1;
+		uint16_t	VI_ERR_CURR_C				:		1;
+		uint16_t	VI_ERR_CURR_D				:		1;
+		uint16_t	HI_TEMP_STATUS			:		1;
+		uint16_t	CHARGE_PUMP_STATUS	:		1;
+		uint16_t	ALDO5V_STATUS				:		1;
+		uint16_t	AVDD_STATUS					:		1;
+		uint16_t	DVCC_STATUS					:		1;
+		uint16_t	ALDO1V8_STATUS			:		1;
+		uint16_t	ADC_CH_CURR					:		3;
+		uint16_t	ADC_BUSY						:		1;
+		uint16_t	ADC_DATA_RDY				:		1;
+		uint16_t										:		1;
+	}tLiveStatusInfo;
+	
+	typedef void (*tAlertHandler)(uint8_t API_ref, tAlertInfo alertInfo);
+	
+	typedef struct
+	{
+		bool						irqMode;
+		volatile bool		pending;
+		uint16_t				mask;
+		tAlertHandler		handlers[AD74413R_MAX_ALERT_HANDLERS];
+	}tAlertCtrl;
+	
+	typedef struct
+	{
+		bool			resetPending;		///< Чип сброшен, конфигурация ещё не восстановлена
+		bool			checkPending;		///< Чип отбросил кадр, конфигурация ещё не сверена
+		uint32_t	resetCount;			///< Сбросы чипа (RESET_OCCURRED)
+		uint32_t	crcErrCount;		///< Кадры, отброшенные чипом (SPI_CRC_ERR)
+		uint32_t	replayCount;		///< Восстановления с перезаписью регистров
+		uint32_t	failCount;			///< Неудачные попытки восстановления
+	}tRecoveryInfo;
+	
+	typedef struct
+	{
+		bool						onDemand;													///< Преобразования только по запросу AD74413R_convertOnce
+		bool						weighted;													///< Взвешенный опрос (одиночные последовательности)
+		uint8_t					period[AD74413R_NUMBER_OF_SEQ_SLOTS];	///< Период слота в последовательностях, 0/1 - каждая
+		uint32_t				count;														///< Номер текущей последовательности
+		uint8_t					mask;															///< Слоты текущей последовательности
+	}tSeqCtrl;
 	
 
 	
@@ -840,9 +1078,26 @@
 		uint8_t						chUsage;
 		tChannelInfo			chInfo[AD74413R_NUMBER_OF_CHANNELS];
 		tDiagnosticInfo		diagInfo[AD74413R_NUMBER_OF_DIAGNOSTICS];
+		uint16_t					diagAssign;
+		tDiagRotation			diagRot;
 		tAlertInfo				alertInfo;
+		tAlertCtrl				alertCtrl;
+		tRecoveryInfo			recovery;
+		tSeqCtrl					seqCtrl;
+		tLiveStatusInfo		liveStatusInfo;
+		bool							liveStatusGating;
+		bool							lazyValues;
+		uint8_t						freshMask;
+		uint16_t					dinThresh;
+		uint8_t						gpoParallel;
+		uint16_t					safeTriggerMask;
+		uint8_t						viErr;
+		uint32_t					safeTriggerCount;
+		tDinSnapshot			dinSnap;
 		tRegister					readReg[AD74413R_MAX_NUM_REGS_TO_READ];
 		uint8_t						chipStatus;
+		uint32_t					refreshMs;
+		uint32_t					lastRefreshMs;
 	}AD74413R_API;
 	
 	
@@ -852,7 +1107,7 @@
 	// прототипы функций
 	void	AD74413R_hwReset(void);
 	
-	void	AD74413R_init(uint8_t					API_ref,
+	AD74413R_RESULT	AD74413R_init(uint8_t					API_ref,
 									MDR_SSP_TypeDef			*SSPx,
 									MDR_PORT_TypeDef*		csPORTx,
 									uint32_t						csPORT_Pin,
@@ -861,10 +1116,24 @@
 									MDR_PORT_TypeDef*		adcRdyPORTx,
 									uint32_t						adcRdyPORT_Pin);
 	
+	AD74413R_RESULT	AD74413R_resetChip(uint8_t	API_ref);
+	bool	AD74413R_getRecoveryInfo(uint8_t				API_ref,
+																tRecoveryInfo	*pInfo);
+	
 	void	AD74413R_analyzeChipStatus(uint8_t	API_ref);
+	void	AD74413R_setLiveStatusGating(uint8_t	API_ref,
+																		bool	enable);
 	
-	void	AD74413R_turnChipInWork(uint8_t	API_ref,
-																	bool	inUse);
+	AD74413R_RESULT	AD74413R_turnChipInWork(uint8_t	API_ref,
+																					bool		inWork);
+	uint8_t	AD74413R_getChipState(uint8_t	API_ref);
+	
+	AD74413R_RESULT	AD74413R_setAlertPolicy(uint8_t		API_ref,
+																					uint16_t	alertEnMask,
+																					bool			irqMode);
+	AD74413R_RESULT	AD74413R_registerAlertHandler(uint8_t				API_ref,
+																								tAlertHandler	handler);
+	void	AD74413R_alertIrqHandler(uint8_t	API_ref);
 	
 	void	AD74413R_setRegData(uint8_t		API_ref,
 														uint8_t		nRegAdr,
@@ -877,12 +1146,70 @@
 														uint8_t		chId,
 								AD74413R_CHANNEL_MODE		chMode);
 	
+	AD74413R_RESULT	AD74413R_setAdcConfig(uint8_t		API_ref,
+																				uint8_t		chId,
+																				uint16_t	adcRange,
+																				uint16_t	adcRate);
+	void	AD74413R_setAutoRange(uint8_t		API_ref,
+															uint8_t		chId,
+															bool			enable);
+	AD74413R_RESULT	AD74413R_setSpikeFilter(uint8_t								API_ref,
+																					uint8_t								chId,
+																					AD74413R_FILTER_MODE	mode);
+	void	AD74413R_setFaultWindow(uint8_t	API_ref,
+																uint8_t	chId,
+																float		minVal,
+																float		maxVal,
+																bool		enable);
+	AD74413R_FAULT_STATE	AD74413R_getFaultState(uint8_t	API_ref,
+																							uint8_t	chId);
+	uint32_t	AD74413R_getFaultCount(uint8_t	API_ref,
+																	uint8_t	chId);
+	uint32_t	AD74413R_getRejectedCount(uint8_t	API_ref,
+																		uint8_t	chId);
+	void	AD74413R_setWireRes(uint8_t	API_ref,
+														uint8_t	chId,
+														float		wireRes);
+	void	AD74413R_setRtdType(uint8_t							API_ref,
+														uint8_t							chId,
+														AD74413R_RTD_TYPE	rtdType);
+	void	AD74413R_setTcType(uint8_t						API_ref,
+													uint8_t						chId,
+													AD74413R_TC_TYPE	tcType);
+	bool	AD74413R_getCjcTemperature(uint8_t	API_ref,
+																	float		*pCjcDeg);
+	
 	AD74413R_RESULT	AD74413R_setOutputVoltageOnCh(uint8_t		API_ref,
 																								uint8_t		chId,
 																								float		volt);
 	void	AD74413R_setOutputCurrentOnCh(uint8_t		API_ref,
 																			uint8_t		chId,
 																				float		mA);
+	AD74413R_RESULT	AD74413R_rampOutputOnCh(uint8_t		API_ref,
+																					uint8_t		chId,
+																					float			target,
+																					uint32_t	rampMs);
+	bool	AD74413R_isRampActive(uint8_t	API_ref,
+															uint8_t	chId);
+	
+	AD74413R_RESULT	AD74413R_setRegulator(uint8_t		API_ref,
+																				uint8_t		chId,
+																				float			kp,
+																				float			ki,
+																				uint16_t	maxStep);
+	AD74413R_RESULT	AD74413R_setRegulatorSetpoint(uint8_t	API_ref,
+																								uint8_t	chId,
+																								float		setpoint);
+	void	AD74413R_stopRegulator(uint8_t	API_ref,
+															uint8_t	chId);
+	
+	AD74413R_RESULT	AD74413R_setSafeState(uint8_t	API_ref,
+																				uint8_t	chId,
+																				float		safeVal,
+																				bool		enable);
+	void	AD74413R_setSafeStateTrigger(uint8_t		API_ref,
+																		uint16_t	alertMask);
+	AD74413R_RESULT	AD74413R_triggerSafeState(uint8_t	API_ref);
 	
 	void	AD74413R_setDiagMode(uint8_t	API_ref,
 														uint8_t		diagId,
@@ -892,10 +1219,87 @@
 														uint8_t		chId);
 	float	AD74413R_getDiagValue(uint8_t		API_ref,
 														uint8_t		diagId);
+	AD74413R_RESULT	AD74413R_applyProfile(uint8_t						API_ref,
+																				const tChProfile	*pProfile);
+	void	AD74413R_setDiagRotation(uint8_t		API_ref,
+																	uint8_t		slotMask,
+																	uint16_t	srcMask,
+																	uint32_t	periodMs);
+	float	AD74413R_getDiagSourceValue(uint8_t										API_ref,
+																		AD74413R_DIAGNOSTIC_MODE	diagSrc);
+	
+	void	AD74413R_setAccuracyTest(uint8_t		API_ref,
+																uint8_t		chId,
+																float			actualVal,
+																uint32_t	samples);
+	void	AD74413R_resetStats(uint8_t	API_ref,
+														uint8_t	chId);
+	void	AD74413R_setStatsHistogram(uint8_t		API_ref,
+																	uint8_t		chId,
+																	uint16_t	codeMin,
+																	uint8_t		codeShift);
+	bool	AD74413R_getAccuracy(uint8_t		API_ref,
+														uint8_t		chId,
+														tAccuracy	*pAccuracy);
+	const tStats	*AD74413R_getStats(uint8_t	API_ref,
+																		uint8_t	chId);
+	
+	void	AD74413R_setWindow(uint8_t		API_ref,
+													uint8_t		chId,
+													uint32_t	windowMs);
+	bool	AD74413R_getWindowValues(uint8_t	API_ref,
+																uint8_t	chId,
+																float		*pMin,
+																float		*pMax,
+																float		*pMean,
+																uint16_t	*pCount,
+																uint32_t	*pSpanMs);
+	
+	AD74413R_RESULT	AD74413R_setDinConfig(uint8_t		API_ref,
+																				uint8_t		chId,
+																				uint8_t		debounceTime,
+																				uint8_t		sinkCurrent,
+																				bool			countEn);
+	AD74413R_RESULT	AD74413R_setDinThreshold(uint8_t	API_ref,
+																					uint8_t		compThresh,
+																					bool			relToVref);
+	uint32_t	AD74413R_getDinCount(uint8_t	API_ref,
+																uint8_t		chId);
+	float	AD74413R_getDinFrequency(uint8_t	API_ref,
+																uint8_t		chId);
+	void	AD74413R_clearDinCount(uint8_t	API_ref,
+															uint8_t		chId);
+	
+	AD74413R_RESULT	AD74413R_snapshotDin(uint8_t	API_ref);
+	uint8_t	AD74413R_getDinState(uint8_t	API_ref);
+	bool	AD74413R_popDinEvent(uint8_t		API_ref,
+														tDinEvent	*pEvent);
 	
 	void	AD74413R_setGPO(uint8_t	API_ref, uint8_t chId);
 	void	AD74413R_resetGPO(uint8_t	API_ref, uint8_t chId);
+	AD74413R_RESULT	AD74413R_setGpoParallelMode(uint8_t	API_ref,
+																							uint8_t	chMask);
+	AD74413R_RESULT	AD74413R_writeGpoParallel(uint8_t	API_ref,
+																						uint8_t	levelMask);
+	
+	void	AD74413R_setRefreshPeriod(uint8_t		API_ref,
+																	uint32_t	refreshMs);
+	void	AD74413R_setLazyValues(uint8_t	API_ref,
+																bool		enable);
+	void	AD74413R_setChSeqPeriod(uint8_t	API_ref,
+																uint8_t	chId,
+																uint8_t	period);
+	void	AD74413R_setDiagSeqPeriod(uint8_t	API_ref,
+																	uint8_t	diagId,
+																	uint8_t	period);
+	void	AD74413R_setOnDemandMode(uint8_t	API_ref,
+																bool		enable);
+	AD74413R_RESULT	AD74413R_convertOnce(uint8_t		API_ref,
+																			uint8_t		slotMask,
+																			uint16_t	*pCodes,
+																			uint32_t	*pLatencyUs);
 	
+	void	AD74413R_tick1ms(void);
 	void	AD74413R_handler(void);
 	
 
@@ -0,0 +1,37 @@
+
+#ifndef AD74413R_FRAME_H
+	#define AD74413R_FRAME_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	
+	
+	#define AD74413R_FRAME_WORDS			2			///< Количество 16-битных слов SPI в одном кадре
+	#define AD74413R_FRAME_READ_FLAG	0x80	///< Старший бит кадра ответа (SPI_RD_RET_INFO = 0)
+	
+	
+	/*!
+		\brief Адрес и данные регистра
+	 */ 
+	typedef struct
+	{
+		uint8_t		regAdr;		///< Адрес регистра
+		uint16_t	regData;	///< Данные регистра
+	}tRegister;
+	
+	
+	// Прототипы функций
+	uint8_t		AD74413R_frameCRC(uint8_t byte0, uint8_t byte1, uint8_t byte2);
+	
+	void			AD74413R_frameEncode(uint8_t nRegAdr, uint16_t nData, uint16_t *pWords);
+	bool			AD74413R_frameDecode(const uint16_t *pWords, uint8_t nRegAdr, uint16_t *pData);
+	
+	uint16_t	AD74413R_frameEncodeBatch(const tRegister	*pRegs,
+																			uint16_t		count,
+																			uint16_t		*pWords);
+	uint16_t	AD74413R_frameDecodeBatch(const uint16_t	*pWords,
+																			tRegister			*pRegs,
+																			uint16_t			count);
+	
+	
+#endif
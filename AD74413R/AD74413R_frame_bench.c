@@ -0,0 +1,92 @@
+/*!
+	\defgroup AD74413R_FRAME_BENCH Проверка кодека SPI кадров AD74413R на ПК
+	\details Сравнение табличного CRC-8 с побитовым расчётом по всем 2^24 входам
+						и замер времени обоих вариантов. В прошивку не входит, сборка на ПК:
+						gcc -O2 -DAD74413R_HOST_TEST AD74413R_frame_bench.c AD74413R_frame.c -o frame_bench
+ */
+///@{
+
+#ifdef AD74413R_HOST_TEST
+
+#include <stdio.h>
+#include <time.h>
+
+#include "AD74413R_frame.h"
+
+
+#define BENCH_ROUNDS		4			///< Количество проходов по всем входам при замере
+
+
+/*!
+	\brief Побитовый расчёт CRC-8 (полином 0x107, начальное значение 0)
+ */
+static uint8_t bitLoopCRC(uint8_t byte0, uint8_t byte1, uint8_t byte2)
+{
+	uint8_t bytes[3] = {byte0, byte1, byte2};
+	uint8_t crc = 0;
+	
+	for(uint8_t i = 0; i < 3; i++)
+	{
+		crc ^= bytes[i];
+		for(uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	
+	return crc;
+}
+
+
+/*!
+	\brief Время BENCH_ROUNDS проходов по всем входам, нс на кадр
+ */
+static double benchCRC(uint8_t (*pCRC)(uint8_t, uint8_t, uint8_t), uint32_t *pSum)
+{
+	clock_t	start	=	clock();
+	uint32_t	sum		=	0;
+	
+	for(uint8_t round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for(uint32_t frame = 0; frame < (1UL << 24); frame++)
+			sum += pCRC((uint8_t)(frame >> 16), (uint8_t)(frame >> 8), (uint8_t)frame);
+	}
+	
+	*pSum = sum;
+	
+	return (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)BENCH_ROUNDS * (1UL << 24));
+}
+
+
+int main(void)
+{
+	uint32_t	errors	=	0;
+	uint32_t	sumTable, sumLoop;
+	double		nsTable, nsLoop;
+	
+	// контрольные значения из описания чипа
+	if(AD74413R_frameCRC(0x41, 0x00, 0x2E) != 0x27)
+		errors++;
+	if(AD74413R_frameCRC(0xAE, 0xA0, 0x20) != 0x9C)
+		errors++;
+	
+	for(uint32_t frame = 0; frame < (1UL << 24); frame++)
+	{
+		uint8_t byte0	=	(uint8_t)(frame >> 16);
+		uint8_t byte1	=	(uint8_t)(frame >> 8);
+		uint8_t byte2	=	(uint8_t)frame;
+		
+		if(AD74413R_frameCRC(byte0, byte1, byte2) != bitLoopCRC(byte0, byte1, byte2))
+			errors++;
+	}
+	
+	nsTable	=	benchCRC(AD74413R_frameCRC, &sumTable);
+	nsLoop	=	benchCRC(bitLoopCRC, &sumLoop);
+	
+	printf("CRC mismatches: %lu\n", (unsigned long)errors);
+	printf("table:    %.2f ns/frame\n", nsTable);
+	printf("bit loop: %.2f ns/frame (x%.1f)\n", nsLoop, nsLoop / nsTable);
+	
+	return ((errors == 0) && (sumTable == sumLoop)) ? 0 : 1;
+}
+
+#endif
+///@}
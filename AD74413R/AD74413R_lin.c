@@ -0,0 +1,294 @@
+/*!
+	\defgroup AD74413R_LIN Линеаризация датчиков AD74413R
+	\details Пересчёт сопротивления термометров сопротивления и ТЭДС термопар
+						в температуру по кусочно-линейным таблицам: двоичный поиск
+						отрезка и целочисленная интерполяция внутри него
+ */
+///@{
+
+#include "AD74413R_lin.h"
+
+
+/*!
+	\brief Сопротивление Pt100 по уравнению Каллендара - Ван Дюзена (IEC 60751), 0,01 Ом
+	\details От -200 до 850 °C с шагом 25 °C; для Pt1000 используется
+						та же таблица с масштабом 10
+ */
+static const uint16_t pt100Table[] =
+{
+	 1852,  2922,  3972,  5006,  6026,  7033,  8031,  9019,
+	10000, 10973, 11940, 12899, 13851, 14795, 15733, 16663,
+	17586, 18501, 19410, 20311, 21205, 22092, 22972, 23844,
+	24709, 25567, 26418, 27261, 28098, 28927, 29749, 30563,
+	31371, 32171, 32964, 33750, 34528, 35300, 36064, 36821,
+	37570, 38313, 39048
+};
+
+
+/*!
+	\brief Сопротивление Ni120 (ТКС 0,00672), 0,01 Ом
+	\details От -80 до 260 °C с шагом 10 °C; кубическая аппроксимация
+						по опорным точкам -80, 100 и 260 °C
+ */
+static const uint16_t ni120Table[] =
+{
+	 6660,  7289,  7928,  8576,  9236,  9907, 10591, 11289,
+	12000, 12726, 13468, 14227, 15003, 15796, 16609, 17441,
+	18294, 19168, 20064, 20983, 21925, 22892, 23883, 24901,
+	25945, 27017, 28117, 29247, 30406, 31595, 32816, 34070,
+	35356, 36676, 38031
+};
+
+
+/*!
+	\brief Описание таблицы термометра сопротивления
+ */
+typedef struct
+{
+	const uint16_t	*pTable;	///< Сопротивление в узлах, 0,01 Ом
+	uint8_t					size;			///< Количество узлов
+	int16_t					tMin;			///< Температура первого узла, °C
+	uint8_t					step;			///< Шаг узлов, °C
+	uint8_t					resMul;		///< Масштаб сопротивления датчика относительно таблицы
+}tRtdCurve;
+
+
+static const tRtdCurve rtdCurves[] =
+{
+	[AD74413R_RTD_PT100]	=	{pt100Table,	sizeof(pt100Table)/sizeof(pt100Table[0]),	-200,	25,	1},
+	[AD74413R_RTD_PT1000]	=	{pt100Table,	sizeof(pt100Table)/sizeof(pt100Table[0]),	-200,	25,	10},
+	[AD74413R_RTD_NI120]	=	{ni120Table,	sizeof(ni120Table)/sizeof(ni120Table[0]),	-80,	10,	1},
+};
+
+
+/*!
+	\brief Температура термометра сопротивления
+	\details Целочисленный расчёт; сопротивление Pt1000 сравнивается с узлами
+						таблицы Pt100, умноженными на 10, без потери разрешения
+	\param rtdType		Тип датчика
+	\param resCentiOhm	Сопротивление, 0,01 Ом
+	\param pCentiDeg	Температура, 0,01 °C; вне диапазона таблицы - граница диапазона
+	\return false - тип не задан или сопротивление вне диапазона таблицы
+ */
+bool AD74413R_rtdToCentiDeg(AD74413R_RTD_TYPE rtdType, uint32_t resCentiOhm, int32_t *pCentiDeg)
+{
+	const tRtdCurve	*pCurve	=	0;
+	uint32_t				resLo		=	0;
+	uint32_t				span		=	0;
+	uint8_t					lo			=	0;
+	uint8_t					hi			=	0;
+	uint8_t					mid			=	0;
+	
+	if((rtdType == AD74413R_RTD_NONE) || (rtdType > AD74413R_RTD_NI120))
+		return false;
+	
+	pCurve	=	&rtdCurves[rtdType];
+	hi			=	pCurve->size - 1;
+	
+	if(resCentiOhm < (uint32_t)pCurve->pTable[0]*pCurve->resMul)
+	{
+		*pCentiDeg = pCurve->tMin*100;
+		return false;
+	}
+	if(resCentiOhm > (uint32_t)pCurve->pTable[hi]*pCurve->resMul)
+	{
+		*pCentiDeg = (pCurve->tMin + hi*pCurve->step)*100;
+		return false;
+	}
+	
+	// поиск отрезка pTable[lo] <= R <= pTable[hi]
+	while((hi - lo) > 1)
+	{
+		mid = (lo + hi)/2;
+		if(resCentiOhm >= (uint32_t)pCurve->pTable[mid]*pCurve->resMul)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	
+	resLo	=	(uint32_t)pCurve->pTable[lo]*pCurve->resMul;
+	span	=	(uint32_t)(pCurve->pTable[hi] - pCurve->pTable[lo])*pCurve->resMul;
+	
+	*pCentiDeg = (pCurve->tMin + lo*pCurve->step)*100
+								+ (int32_t)(((resCentiOhm - resLo)*pCurve->step*100 + span/2) / span);
+	
+	return true;
+}
+
+
+/*!
+	\brief ТЭДС термопары типа K по NIST ITS-90, мкВ
+	\details От -200 до 1370 °C с шагом 10 °C
+ */
+static const int32_t tcKTable[] =
+{
+	 -5891,  -5730,  -5550,  -5354,  -5141,  -4913,  -4669,  -4411,
+	 -4138,  -3852,  -3554,  -3243,  -2920,  -2587,  -2243,  -1889,
+	 -1527,  -1156,   -778,   -392,      0,    397,    798,   1203,
+	  1612,   2023,   2436,   2851,   3267,   3682,   4096,   4509,
+	  4920,   5328,   5735,   6138,   6540,   6941,   7340,   7739,
+	  8138,   8539,   8940,   9343,   9747,  10153,  10561,  10971,
+	 11382,  11795,  12209,  12624,  13040,  13457,  13874,  14293,
+	 14713,  15133,  15554,  15975,  16397,  16820,  17243,  17667,
+	 18091,  18516,  18941,  19366,  19792,  20218,  20644,  21071,
+	 21497,  21924,  22350,  22776,  23203,  23629,  24055,  24480,
+	 24905,  25330,  25755,  26179,  26602,  27025,  27447,  27869,
+	 28289,  28710,  29129,  29548,  29965,  30382,  30798,  31213,
+	 31628,  32041,  32453,  32865,  33275,  33685,  34093,  34501,
+	 34908,  35313,  35718,  36121,  36524,  36925,  37326,  37725,
+	 38124,  38522,  38918,  39314,  39708,  40101,  40494,  40885,
+	 41276,  41665,  42053,  42440,  42826,  43211,  43595,  43978,
+	 44359,  44740,  45119,  45497,  45873,  46249,  46623,  46995,
+	 47367,  47737,  48105,  48473,  48838,  49202,  49565,  49926,
+	 50286,  50644,  51000,  51355,  51708,  52060,  52410,  52759,
+	 53106,  53451,  53795,  54138,  54479,  54819
+};
+
+
+/*!
+	\brief ТЭДС термопары типа J по NIST ITS-90, мкВ
+	\details От -200 до 760 °C с шагом 10 °C
+ */
+static const int32_t tcJTable[] =
+{
+	 -7890,  -7659,  -7403,  -7123,  -6821,  -6500,  -6159,  -5801,
+	 -5426,  -5037,  -4633,  -4215,  -3786,  -3344,  -2893,  -2431,
+	 -1961,  -1482,   -995,   -501,      0,    507,   1019,   1537,
+	  2059,   2585,   3116,   3650,   4187,   4726,   5269,   5814,
+	  6360,   6909,   7459,   8010,   8562,   9115,   9669,  10224,
+	 10779,  11334,  11889,  12445,  13000,  13555,  14110,  14665,
+	 15219,  15773,  16327,  16881,  17434,  17986,  18538,  19090,
+	 19642,  20194,  20745,  21297,  21848,  22400,  22952,  23504,
+	 24057,  24610,  25164,  25720,  26276,  26834,  27393,  27953,
+	 28516,  29080,  29647,  30216,  30788,  31362,  31939,  32519,
+	 33102,  33689,  34279,  34873,  35470,  36071,  36675,  37284,
+	 37896,  38512,  39132,  39755,  40382,  41012,  41645,  42281,
+	 42919
+};
+
+
+/*!
+	\brief ТЭДС термопары типа T по NIST ITS-90, мкВ
+	\details От -200 до 400 °C с шагом 10 °C
+ */
+static const int32_t tcTTable[] =
+{
+	 -5603,  -5439,  -5261,  -5070,  -4865,  -4648,  -4419,  -4177,
+	 -3923,  -3657,  -3379,  -3089,  -2788,  -2476,  -2153,  -1819,
+	 -1475,  -1121,   -757,   -383,      0,    391,    790,   1196,
+	  1612,   2036,   2468,   2909,   3358,   3814,   4279,   4750,
+	  5228,   5714,   6206,   6704,   7209,   7720,   8237,   8759,
+	  9288,   9822,  10362,  10907,  11458,  12013,  12574,  13139,
+	 13709,  14283,  14862,  15445,  16032,  16624,  17219,  17819,
+	 18422,  19030,  19641,  20255,  20872
+};
+
+
+/*!
+	\brief Описание таблицы термопары
+ */
+typedef struct
+{
+	const int32_t		*pTable;	///< ТЭДС в узлах, мкВ
+	uint8_t					size;			///< Количество узлов
+	int16_t					tMin;			///< Температура первого узла, °C
+	uint8_t					step;			///< Шаг узлов, °C
+}tTcCurve;
+
+
+static const tTcCurve tcCurves[] =
+{
+	[AD74413R_TC_K]	=	{tcKTable,	sizeof(tcKTable)/sizeof(tcKTable[0]),	-200,	10},
+	[AD74413R_TC_J]	=	{tcJTable,	sizeof(tcJTable)/sizeof(tcJTable[0]),	-200,	10},
+	[AD74413R_TC_T]	=	{tcTTable,	sizeof(tcTTable)/sizeof(tcTTable[0]),	-200,	10},
+};
+
+
+/*!
+	\brief ТЭДС термопары при температуре рабочего спая
+	\details Используется для компенсации холодного спая: ТЭДС при температуре
+						холодного спая прибавляется к измеренной
+	\param tcType		Тип термопары
+	\param centiDeg	Температура, 0,01 °C; вне диапазона таблицы ограничивается
+	\return ТЭДС, мкВ; 0 - тип не задан
+ */
+int32_t AD74413R_tcToMicroVolt(AD74413R_TC_TYPE tcType, int32_t centiDeg)
+{
+	const tTcCurve	*pCurve	=	0;
+	int32_t					offset	=	0;
+	int32_t					span		=	0;
+	int32_t					rem			=	0;
+	int32_t					delta		=	0;
+	uint8_t					lo			=	0;
+	
+	if((tcType == AD74413R_TC_NONE) || (tcType > AD74413R_TC_T))
+		return 0;
+	
+	pCurve	=	&tcCurves[tcType];
+	offset	=	centiDeg - pCurve->tMin*100;
+	span		=	pCurve->step*100;
+	
+	if(offset <= 0)
+		return pCurve->pTable[0];
+	if(offset >= (pCurve->size - 1)*span)
+		return pCurve->pTable[pCurve->size - 1];
+	
+	lo		=	offset / span;
+	rem		=	offset % span;
+	delta	=	(pCurve->pTable[lo + 1] - pCurve->pTable[lo])*rem;
+	
+	// деление с округлением к ближайшему для отрезков обоих знаков наклона
+	return pCurve->pTable[lo] + ((delta >= 0)?((delta + span/2) / span):-((-delta + span/2) / span));
+}
+
+
+/*!
+	\brief Температура рабочего спая термопары
+	\param tcType			Тип термопары
+	\param microVolt		ТЭДС относительно 0 °C (с учётом холодного спая), мкВ
+	\param pCentiDeg		Температура, 0,01 °C; вне диапазона таблицы - граница диапазона
+	\return false - тип не задан или ТЭДС вне диапазона таблицы
+ */
+bool AD74413R_tcToCentiDeg(AD74413R_TC_TYPE tcType, int32_t microVolt, int32_t *pCentiDeg)
+{
+	const tTcCurve	*pCurve	=	0;
+	uint32_t				span		=	0;
+	uint8_t					lo			=	0;
+	uint8_t					hi			=	0;
+	uint8_t					mid			=	0;
+	
+	if((tcType == AD74413R_TC_NONE) || (tcType > AD74413R_TC_T))
+		return false;
+	
+	pCurve	=	&tcCurves[tcType];
+	hi			=	pCurve->size - 1;
+	
+	if(microVolt < pCurve->pTable[0])
+	{
+		*pCentiDeg = pCurve->tMin*100;
+		return false;
+	}
+	if(microVolt > pCurve->pTable[hi])
+	{
+		*pCentiDeg = (pCurve->tMin + hi*pCurve->step)*100;
+		return false;
+	}
+	
+	// поиск отрезка pTable[lo] <= E <= pTable[hi]
+	while((hi - lo) > 1)
+	{
+		mid = (lo + hi)/2;
+		if(microVolt >= pCurve->pTable[mid])
+			lo = mid;
+		else
+			hi = mid;
+	}
+	
+	span = (uint32_t)(pCurve->pTable[hi] - pCurve->pTable[lo]);
+	
+	*pCentiDeg = (pCurve->tMin + lo*pCurve->step)*100
+								+ (int32_t)(((uint32_t)(microVolt - pCurve->pTable[lo])*pCurve->step*100 + span/2) / span);
+	
+	return true;
+}
+///@}
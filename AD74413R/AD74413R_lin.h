@@ -0,0 +1,38 @@
+#ifndef AD74413R_LIN_H
+	#define AD74413R_LIN_H
+	
+	#include <stdint.h>
+	#include <stdbool.h>
+	
+	
+	/*!
+		\brief Тип термометра сопротивления
+	 */
+	typedef enum
+	{
+		AD74413R_RTD_NONE		=	0x00,		///< Линеаризация выключена, значение - сопротивление
+		AD74413R_RTD_PT100	=	0x01,		///< Pt100, IEC 60751 (альфа 0,00385), от -200 до 850 °C
+		AD74413R_RTD_PT1000	=	0x02,		///< Pt1000, IEC 60751 (альфа 0,00385), от -200 до 850 °C
+		AD74413R_RTD_NI120	=	0x03		///< Ni120 (ТКС 0,00672), от -80 до 260 °C
+	}AD74413R_RTD_TYPE;
+	
+	/*!
+		\brief Тип термопары
+	 */
+	typedef enum
+	{
+		AD74413R_TC_NONE	=	0x00,		///< Линеаризация выключена, значение - ТЭДС, мВ
+		AD74413R_TC_K			=	0x01,		///< Тип K (хромель-алюмель), от -200 до 1370 °C
+		AD74413R_TC_J			=	0x02,		///< Тип J (железо-константан), от -200 до 760 °C
+		AD74413R_TC_T			=	0x03		///< Тип T (медь-константан), от -200 до 400 °C
+	}AD74413R_TC_TYPE;
+	
+	
+	// Прототипы функций
+	bool		AD74413R_rtdToCentiDeg(AD74413R_RTD_TYPE rtdType, uint32_t resCentiOhm, int32_t *pCentiDeg);
+	
+	int32_t	AD74413R_tcToMicroVolt(AD74413R_TC_TYPE tcType, int32_t centiDeg);
+	bool		AD74413R_tcToCentiDeg(AD74413R_TC_TYPE tcType, int32_t microVolt, int32_t *pCentiDeg);
+	
+
+#endif
@@ -0,0 +1,353 @@
+/*!
+	\defgroup AD74413R_LIN_TEST Проверка линеаризации датчиков AD74413R на ПК
+	\details Сравнение табличной линеаризации с исходными уравнениями датчиков
+						(Каллендара - Ван Дюзена, Ni120, полиномы NIST ITS-90 для термопар)
+						во всём диапазоне с шагом 0,01 °C и замер времени одного пересчёта.
+						В прошивку не входит, сборка на ПК:
+						gcc -O2 -DAD74413R_HOST_TEST AD74413R_lin_test.c AD74413R_lin.c -lm -o lin_test
+ */
+///@{
+
+#ifdef AD74413R_HOST_TEST
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "AD74413R_lin.h"
+
+
+#define RTD_MAX_ERR_DEG		0.1		///< Допустимая погрешность термометров сопротивления, °C
+#define TC_MAX_ERR_DEG		0.25	///< Допустимая погрешность термопар с учётом холодного спая, °C
+#define BENCH_CALLS				10000000UL	///< Количество пересчётов при замере времени
+
+
+/*!
+	\brief Сопротивление платинового термометра по уравнению Каллендара - Ван Дюзена (IEC 60751), Ом
+ */
+static double cvdOhm(double r0, double t)
+{
+	const double A	=	3.9083e-3;
+	const double B	=	-5.775e-7;
+	const double C	=	-4.183e-12;
+	
+	if(t < 0)
+		return r0*(1 + A*t + B*t*t + C*(t - 100)*t*t*t);
+	
+	return r0*(1 + A*t + B*t*t);
+}
+
+static double pt100Ohm(double t)	{ return cvdOhm(100.0, t); }
+static double pt1000Ohm(double t)	{ return cvdOhm(1000.0, t); }
+
+/*!
+	\brief Сопротивление Ni120 (ТКС 0,00672), Ом
+ */
+static double ni120Ohm(double t)
+{
+	return 120.0*(1 + 5.989535570638512e-3*t + 6.212033371040724e-6*t*t + 1.092610922574158e-8*t*t*t);
+}
+
+
+/*!
+	\brief Описание проверяемого термометра сопротивления
+ */
+typedef struct
+{
+	AD74413R_RTD_TYPE	type;
+	const char				*name;
+	double						(*pOhm)(double t);
+	int16_t						tMin;
+	int16_t						tMax;
+}tRtdCase;
+
+
+static const tRtdCase rtdCases[] =
+{
+	{AD74413R_RTD_PT100,	"Pt100",	pt100Ohm,		-200,	850},
+	{AD74413R_RTD_PT1000,	"Pt1000",	pt1000Ohm,	-200,	850},
+	{AD74413R_RTD_NI120,	"Ni120",	ni120Ohm,		-80,	260},
+};
+
+
+/*!
+	\brief Проход по диапазону термометра с шагом 0,01 °C
+	\details Крайние узлы не проверяются: округление таблицы до 0,01 Ом
+						может вывести их за диапазон
+	\return Количество точек с погрешностью выше RTD_MAX_ERR_DEG
+ */
+static uint32_t checkRtd(const tRtdCase *pCase)
+{
+	uint32_t	errors	=	0;
+	double		maxErr	=	0;
+	
+	for(int32_t centiDeg = pCase->tMin*100 + 1; centiDeg < pCase->tMax*100; centiDeg++)
+	{
+		uint32_t	resCentiOhm	=	(uint32_t)lround(pCase->pOhm(centiDeg/100.0)*100);
+		int32_t		result			=	0;
+		double		err					=	0;
+		
+		if(!AD74413R_rtdToCentiDeg(pCase->type, resCentiOhm, &result))
+		{
+			errors++;
+			continue;
+		}
+		
+		err = fabs((result - centiDeg)/100.0);
+		if(err > maxErr)
+			maxErr = err;
+		if(err > RTD_MAX_ERR_DEG)
+			errors++;
+	}
+	
+	// за границами таблицы - граница диапазона и признак ошибки
+	{
+		int32_t result = 0;
+		
+		if(AD74413R_rtdToCentiDeg(pCase->type, (uint32_t)lround(pCase->pOhm(pCase->tMin - 1)*100), &result)
+			|| (result != pCase->tMin*100))
+			errors++;
+		if(AD74413R_rtdToCentiDeg(pCase->type, (uint32_t)lround(pCase->pOhm(pCase->tMax + 1)*100), &result)
+			|| (result != pCase->tMax*100))
+			errors++;
+	}
+	
+	printf("%-7s max error %.3f C, errors %lu\n", pCase->name, maxErr, (unsigned long)errors);
+	
+	return errors;
+}
+
+
+/*!
+	\brief Значение полинома с коэффициентами pCoef[0..count-1]
+ */
+static double poly(const double *pCoef, uint8_t count, double t)
+{
+	double sum = 0;
+	
+	for(uint8_t i = count; i > 0; i--)
+		sum = sum*t + pCoef[i - 1];
+	
+	return sum;
+}
+
+
+/*!
+	\brief ТЭДС термопары типа K по NIST ITS-90, мВ
+ */
+static double tcKMilliVolt(double t)
+{
+	static const double neg[] =
+	{
+		0.0,								3.9450128025e-02,		2.3622373598e-05,		-3.2858906784e-07,
+		-4.9904828777e-09,	-6.7509059173e-11,	-5.7410327428e-13,	-3.1088872894e-15,
+		-1.0451609365e-17,	-1.9889266878e-20,	-1.6322697486e-23
+	};
+	static const double pos[] =
+	{
+		-1.7600413686e-02,	3.8921204975e-02,		1.8558770032e-05,		-9.9457592874e-08,
+		3.1840945719e-10,		-5.6072844889e-13,	5.6075059059e-16,		-3.2020720003e-19,
+		9.7151147152e-23,		-1.2104721275e-26
+	};
+	
+	if(t < 0)
+		return poly(neg, sizeof(neg)/sizeof(neg[0]), t);
+	
+	return poly(pos, sizeof(pos)/sizeof(pos[0]), t)
+					+ 0.1185976*exp(-1.183432e-04*(t - 126.9686)*(t - 126.9686));
+}
+
+/*!
+	\brief ТЭДС термопары типа J по NIST ITS-90, мВ
+ */
+static double tcJMilliVolt(double t)
+{
+	static const double coef[] =
+	{
+		0.0,								5.0381187815e-02,		3.0475836930e-05,		-8.5681065720e-08,
+		1.3228195295e-10,		-1.7052958337e-13,	2.0948090697e-16,		-1.2538395336e-19,
+		1.5631725697e-23
+	};
+	
+	return poly(coef, sizeof(coef)/sizeof(coef[0]), t);
+}
+
+/*!
+	\brief ТЭДС термопары типа T по NIST ITS-90, мВ
+ */
+static double tcTMilliVolt(double t)
+{
+	static const double neg[] =
+	{
+		0.0,								3.8748106364e-02,		4.4194434347e-05,		1.1844323105e-07,
+		2.0032973554e-08,		9.0138019559e-10,		2.2651156593e-11,		3.6071154205e-13,
+		3.8493939883e-15,		2.8213521925e-17,		1.4251594779e-19,		4.8768662286e-22,
+		1.0795539270e-24,		1.3945027062e-27,		7.9795153927e-31
+	};
+	static const double pos[] =
+	{
+		0.0,								3.8748106364e-02,		3.3292227880e-05,		2.0618243404e-07,
+		-2.1882256846e-09,	1.0996880928e-11,		-3.0815758772e-14,	4.5479135290e-17,
+		-2.7512901673e-20
+	};
+	
+	if(t < 0)
+		return poly(neg, sizeof(neg)/sizeof(neg[0]), t);
+	
+	return poly(pos, sizeof(pos)/sizeof(pos[0]), t);
+}
+
+
+/*!
+	\brief Описание проверяемой термопары
+ */
+typedef struct
+{
+	AD74413R_TC_TYPE	type;
+	const char				*name;
+	double						(*pMilliVolt)(double t);
+	int16_t						tMin;
+	int16_t						tMax;
+}tTcCase;
+
+
+static const tTcCase tcCases[] =
+{
+	{AD74413R_TC_K,	"K",	tcKMilliVolt,	-200,	1370},
+	{AD74413R_TC_J,	"J",	tcJMilliVolt,	-200,	760},
+	{AD74413R_TC_T,	"T",	tcTMilliVolt,	-200,	400},
+};
+
+
+/*!
+	\brief Проход по диапазону термопары с шагом 0,01 °C при нескольких температурах холодного спая
+	\details Измеренная ТЭДС - разность ТЭДС рабочего и холодного спая, округлённая до 1 мкВ;
+						компенсация выполняется так же, как в драйвере: ТЭДС холодного спая
+						по AD74413R_tcToMicroVolt прибавляется к измеренной. Крайние 0,5 °C
+						не проверяются: у -200 °C наклон K и J около 6 мкВ/°C, и округление
+						ТЭДС выводит их за диапазон
+	\return Количество точек с погрешностью выше TC_MAX_ERR_DEG
+ */
+static uint32_t checkTc(const tTcCase *pCase)
+{
+	static const int16_t cjcDeg[] = {-20, 0, 25, 60};
+	
+	uint32_t	errors	=	0;
+	double		maxErr	=	0;
+	
+	for(uint8_t cj = 0; cj < sizeof(cjcDeg)/sizeof(cjcDeg[0]); cj++)
+	{
+		double	cjcMicroVolt	=	pCase->pMilliVolt(cjcDeg[cj])*1000;
+		int32_t	cjcComp				=	AD74413R_tcToMicroVolt(pCase->type, cjcDeg[cj]*100);
+		
+		// ТЭДС холодного спая по таблице
+		if(fabs(cjcComp - cjcMicroVolt) > 1.5)
+			errors++;
+		
+		for(int32_t centiDeg = pCase->tMin*100 + 50; centiDeg <= pCase->tMax*100 - 50; centiDeg++)
+		{
+			int32_t	microVolt	=	(int32_t)lround(pCase->pMilliVolt(centiDeg/100.0)*1000 - cjcMicroVolt);
+			int32_t	result		=	0;
+			double	err				=	0;
+			
+			if(!AD74413R_tcToCentiDeg(pCase->type, microVolt + cjcComp, &result))
+			{
+				errors++;
+				continue;
+			}
+			
+			err = fabs((result - centiDeg)/100.0);
+			if(err > maxErr)
+				maxErr = err;
+			if(err > TC_MAX_ERR_DEG)
+				errors++;
+		}
+	}
+	
+	// за границами таблицы - граница диапазона и признак ошибки
+	{
+		int32_t result = 0;
+		
+		if(AD74413R_tcToCentiDeg(pCase->type, (int32_t)lround(pCase->pMilliVolt(pCase->tMin - 1)*1000), &result)
+			|| (result != pCase->tMin*100))
+			errors++;
+		if(AD74413R_tcToCentiDeg(pCase->type, (int32_t)lround(pCase->pMilliVolt(pCase->tMax + 1)*1000), &result)
+			|| (result != pCase->tMax*100))
+			errors++;
+	}
+	
+	printf("%-7s max error %.3f C, errors %lu\n", pCase->name, maxErr, (unsigned long)errors);
+	
+	return errors;
+}
+
+
+/*!
+	\brief Замер времени одного пересчёта ТЭДС в температуру с компенсацией холодного спая
+ */
+static void benchTc(const tTcCase *pCase)
+{
+	int32_t		uvMin		=	(int32_t)lround(pCase->pMilliVolt(pCase->tMin)*1000);
+	uint32_t	uvSpan	=	(uint32_t)(lround(pCase->pMilliVolt(pCase->tMax)*1000) - uvMin);
+	int32_t		sum			=	0;
+	int32_t		result	=	0;
+	clock_t		start		=	clock();
+	
+	for(uint32_t i = 0; i < BENCH_CALLS; i++)
+	{
+		// ТЭДС рабочего спая по диапазону, холодный спай от 20 до 30 °C
+		int32_t	cjcComp		=	AD74413R_tcToMicroVolt(pCase->type, 2000 + (int32_t)(i % 1000));
+		int32_t	microVolt	=	uvMin + (int32_t)((i*7919) % uvSpan) - cjcComp;
+		
+		AD74413R_tcToCentiDeg(pCase->type, microVolt + cjcComp, &result);
+		sum += result;
+	}
+	
+	// сумма выводится, чтобы компилятор не выбросил цикл
+	printf("%-7s %.1f ns/call (sum %ld)\n", pCase->name,
+					(double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_CALLS, (long)sum);
+}
+
+
+/*!
+	\brief Замер времени одного пересчёта сопротивления в температуру
+ */
+static void benchRtd(const tRtdCase *pCase)
+{
+	uint32_t	resMin	=	(uint32_t)lround(pCase->pOhm(pCase->tMin)*100);
+	uint32_t	resSpan	=	(uint32_t)lround(pCase->pOhm(pCase->tMax)*100) - resMin;
+	int32_t		sum			=	0;
+	int32_t		result	=	0;
+	clock_t		start		=	clock();
+	
+	for(uint32_t i = 0; i < BENCH_CALLS; i++)
+	{
+		AD74413R_rtdToCentiDeg(pCase->type, resMin + (i*7919) % resSpan, &result);
+		sum += result;
+	}
+	
+	// сумма выводится, чтобы компилятор не выбросил цикл
+	printf("%-7s %.1f ns/call (sum %ld)\n", pCase->name,
+					(double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_CALLS, (long)sum);
+}
+
+
+int main(void)
+{
+	uint32_t errors = 0;
+	
+	for(uint8_t i = 0; i < sizeof(rtdCases)/sizeof(rtdCases[0]); i++)
+		errors += checkRtd(&rtdCases[i]);
+	for(uint8_t i = 0; i < sizeof(tcCases)/sizeof(tcCases[0]); i++)
+		errors += checkTc(&tcCases[i]);
+	
+	for(uint8_t i = 0; i < sizeof(rtdCases)/sizeof(rtdCases[0]); i++)
+		benchRtd(&rtdCases[i]);
+	for(uint8_t i = 0; i < sizeof(tcCases)/sizeof(tcCases[0]); i++)
+		benchTc(&tcCases[i]);
+	
+	return (errors == 0) ? 0 : 1;
+}
+
+#endif
+///@}
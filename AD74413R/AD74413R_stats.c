@@ -0,0 +1,347 @@
+/*!
+	\defgroup AD74413R_STATS Потоковая статистика AD74413R
+	\details Статистика по кодам АЦП каналов: среднее и дисперсия по Уэлфорду,
+						минимум, максимум и гистограмма, а также скользящее окно последних
+						отсчётов. Обновление отсчётом выполняется целочисленно за O(1)
+						(для окна - в среднем), производные величины считаются при запросе
+ */
+///@{
+
+#include "AD74413R_stats.h"
+
+
+/*!
+	\brief Очистка накопленной статистики с сохранением настроек
+	\param pStats	Указатель на статистику
+ */
+static void clearStats(tStats *pStats)
+{
+	pStats->count		=	0;
+	pStats->meanQ16	=	0;
+	pStats->m2Q16		=	0;
+	pStats->min			=	0;
+	pStats->max			=	0;
+	
+	for(uint8_t i = 0; i < AD74413R_STATS_HIST_BUCKETS; i++)
+	{
+		pStats->hist[i] = 0;
+	}
+}
+
+
+/*!
+	\brief Инициализация статистики
+	\details Статистика очищается при следующем обновлении, как и по запросу
+						сброса, поэтому вызов безопасен из любого контекста; настройки
+						гистограммы сохраняются
+	\param pStats	Указатель на статистику
+	\param limit	Предельное количество отсчётов, 0 - без ограничения
+ */
+void AD74413R_statsInit(tStats *pStats, uint32_t limit)
+{
+	pStats->limit = limit;
+	AD74413R_statsRequestReset(pStats);
+}
+
+
+/*!
+	\brief Запрос сброса статистики
+	\details Сброс выполняется при следующем обновлении в контексте,
+						который добавляет отсчёты, поэтому запрос безопасен из любого контекста
+	\param pStats	Указатель на статистику
+ */
+void AD74413R_statsRequestReset(tStats *pStats)
+{
+	pStats->resetReq++;
+}
+
+
+/*!
+	\brief Настройка гистограммы
+	\param pStats			Указатель на статистику
+	\param histMin		Нижняя граница первой корзины
+	\param histShift	Ширина корзины 2^histShift
+ */
+void AD74413R_statsSetHistogram(tStats *pStats, int32_t histMin, uint8_t histShift)
+{
+	pStats->histMin		=	histMin;
+	pStats->histShift	=	histShift;
+	pStats->histEn		=	true;
+	AD74413R_statsRequestReset(pStats);
+}
+
+
+/*!
+	\brief Учёт отсчёта
+	\details Отсчёты до 16 разрядов; M2 не переполняется при размахе на всю шкалу
+						как минимум на протяжении 65536 отсчётов
+	\param pStats	Указатель на статистику
+	\param sample	Отсчёт
+ */
+void AD74413R_statsUpdate(tStats *pStats, int32_t sample)
+{
+	int64_t		sampleQ16	=	(int64_t)sample << AD74413R_STATS_MEAN_SHIFT;
+	int64_t		delta			=	0;
+	int32_t		bucket		=	0;
+	uint16_t	resetReq	=	pStats->resetReq;
+	
+	if(pStats->resetAck != resetReq)
+	{
+		clearStats(pStats);
+		pStats->resetAck = resetReq;
+	}
+	
+	if((pStats->limit != 0) && (pStats->count >= pStats->limit))
+		return;
+	
+	pStats->count++;
+	
+	if(pStats->count == 1)
+	{
+		pStats->meanQ16	=	sampleQ16;
+		pStats->min			=	sample;
+		pStats->max			=	sample;
+	}
+	else
+	{
+		delta = sampleQ16 - pStats->meanQ16;
+		// деление с округлением к ближайшему, чтобы среднее не смещалось
+		pStats->meanQ16 += (delta >= 0)?
+												((delta + (pStats->count/2)) / pStats->count):
+												-((-delta + (pStats->count/2)) / pStats->count);
+		// произведение отклонений в Q8 даёт приращение M2 в Q16 без переполнения
+		pStats->m2Q16 += (uint64_t)((delta / 256) * ((sampleQ16 - pStats->meanQ16) / 256));
+	
+		if(sample < pStats->min)
+			pStats->min = sample;
+		if(sample > pStats->max)
+			pStats->max = sample;
+	}
+	
+	if(pStats->histEn)
+	{
+		bucket = (sample - pStats->histMin) >> pStats->histShift;
+		if(bucket < 0)
+			bucket = 0;
+		if(bucket >= AD74413R_STATS_HIST_BUCKETS)
+			bucket = AD74413R_STATS_HIST_BUCKETS - 1;
+		pStats->hist[bucket]++;
+	}
+}
+
+
+/*!
+	\brief Среднее значение отсчётов
+	\param pStats	Указатель на статистику
+	\return Среднее значение
+ */
+float AD74413R_statsMean(const tStats *pStats)
+{
+	return (float)pStats->meanQ16 / (1UL << AD74413R_STATS_MEAN_SHIFT);
+}
+
+
+/*!
+	\brief Несмещённая дисперсия отсчётов
+	\param pStats	Указатель на статистику
+	\return Дисперсия, 0 при количестве отсчётов меньше двух
+ */
+float AD74413R_statsVariance(const tStats *pStats)
+{
+	float variance = 0.0f;
+	
+	if(pStats->count > 1)
+	{
+		variance = ((float)pStats->m2Q16 / (1UL << 16)) / (pStats->count - 1);
+	}
+	
+	return variance;
+}
+
+
+#define WINDOW_POS(n)		((uint16_t)(n) & (AD74413R_WINDOW_SIZE - 1))
+
+
+/*!
+	\brief Очистка окна с сохранением длительности
+	\param pWindow	Указатель на окно
+ */
+static void clearWindow(tWindow *pWindow)
+{
+	pWindow->first		=	0;
+	pWindow->next			=	0;
+	pWindow->sum			=	0;
+	pWindow->minHead	=	0;
+	pWindow->minTail	=	0;
+	pWindow->maxHead	=	0;
+	pWindow->maxTail	=	0;
+}
+
+
+/*!
+	\brief Удаление самого старого отсчёта окна
+	\param pWindow	Указатель на окно
+ */
+static void evictOldest(tWindow *pWindow)
+{
+	pWindow->sum -= pWindow->code[WINDOW_POS(pWindow->first)];
+	
+	if((pWindow->minHead != pWindow->minTail)
+			&& (pWindow->minDq[WINDOW_POS(pWindow->minHead)] == pWindow->first))
+	{
+		pWindow->minHead++;
+	}
+	if((pWindow->maxHead != pWindow->maxTail)
+			&& (pWindow->maxDq[WINDOW_POS(pWindow->maxHead)] == pWindow->first))
+	{
+		pWindow->maxHead++;
+	}
+	
+	pWindow->first++;
+}
+
+
+/*!
+	\brief Инициализация окна
+	\details Окно очищается при следующем отсчёте, как и по запросу сброса,
+						поэтому длительность можно менять из любого контекста
+	\param pWindow		Указатель на окно
+	\param windowMs	Длительность окна, мс; 0 - окно ограничено только ёмкостью
+ */
+void AD74413R_windowInit(tWindow *pWindow, uint32_t windowMs)
+{
+	pWindow->windowMs = windowMs;
+	AD74413R_windowRequestReset(pWindow);
+}
+
+
+/*!
+	\brief Запрос сброса окна, выполняется при следующем отсчёте
+	\param pWindow	Указатель на окно
+ */
+void AD74413R_windowRequestReset(tWindow *pWindow)
+{
+	pWindow->resetReq++;
+}
+
+
+/*!
+	\brief Добавление отсчёта в окно
+	\details Устаревшие отсчёты удаляются только здесь, поэтому при отсутствии
+						новых отсчётов запросы возвращают значения последнего окна
+	\param pWindow	Указатель на окно
+	\param code			Отсчёт
+	\param ms				Время отсчёта, мс
+ */
+void AD74413R_windowPush(tWindow *pWindow, uint16_t code, uint32_t ms)
+{
+	uint16_t	resetReq	=	pWindow->resetReq;
+	uint16_t	seq				=	0;
+	
+	if(pWindow->resetAck != resetReq)
+	{
+		clearWindow(pWindow);
+		pWindow->resetAck = resetReq;
+	}
+	
+	if((uint16_t)(pWindow->next - pWindow->first) >= AD74413R_WINDOW_SIZE)
+		evictOldest(pWindow);
+	
+	seq = pWindow->next++;
+	pWindow->code[WINDOW_POS(seq)]	=	code;
+	pWindow->ms[WINDOW_POS(seq)]		=	ms;
+	pWindow->sum										+=	code;
+	
+	// из очередей уходят отсчёты, которые уже не станут минимумом/максимумом
+	while((pWindow->minHead != pWindow->minTail)
+				&& (pWindow->code[WINDOW_POS(pWindow->minDq[WINDOW_POS(pWindow->minTail - 1)])] >= code))
+	{
+		pWindow->minTail--;
+	}
+	pWindow->minDq[WINDOW_POS(pWindow->minTail++)] = seq;
+	
+	while((pWindow->maxHead != pWindow->maxTail)
+				&& (pWindow->code[WINDOW_POS(pWindow->maxDq[WINDOW_POS(pWindow->maxTail - 1)])] <= code))
+	{
+		pWindow->maxTail--;
+	}
+	pWindow->maxDq[WINDOW_POS(pWindow->maxTail++)] = seq;
+	
+	if(pWindow->windowMs != 0)
+	{
+		while((uint16_t)(pWindow->next - pWindow->first) > 1
+					&& ((ms - pWindow->ms[WINDOW_POS(pWindow->first)]) > pWindow->windowMs))
+		{
+			evictOldest(pWindow);
+		}
+	}
+}
+
+
+/*!
+	\brief Количество отсчётов в окне
+	\param pWindow	Указатель на окно
+	\return Количество отсчётов
+ */
+uint16_t AD74413R_windowCount(const tWindow *pWindow)
+{
+	return (uint16_t)(pWindow->next - pWindow->first);
+}
+
+
+/*!
+	\brief Время между самым старым и самым новым отсчётами окна
+	\details Меньше заданной длительности, пока окно ограничено ёмкостью
+						AD74413R_WINDOW_SIZE или ещё не заполнено
+	\param pWindow	Указатель на окно
+	\return Охват окна, мс; 0 при количестве отсчётов меньше двух
+ */
+uint32_t AD74413R_windowSpanMs(const tWindow *pWindow)
+{
+	if(AD74413R_windowCount(pWindow) < 2)
+		return 0;
+	
+	return pWindow->ms[WINDOW_POS(pWindow->next - 1)] - pWindow->ms[WINDOW_POS(pWindow->first)];
+}
+
+
+/*!
+	\brief Минимальный отсчёт окна
+	\param pWindow	Указатель на окно
+	\return Минимум, 0 для пустого окна
+ */
+uint16_t AD74413R_windowMin(const tWindow *pWindow)
+{
+	if(pWindow->minHead == pWindow->minTail)
+		return 0;
+	
+	return pWindow->code[WINDOW_POS(pWindow->minDq[WINDOW_POS(pWindow->minHead)])];
+}
+
+
+/*!
+	\brief Максимальный отсчёт окна
+	\param pWindow	Указатель на окно
+	\return Максимум, 0 для пустого окна
+ */
+uint16_t AD74413R_windowMax(const tWindow *pWindow)
+{
+	if(pWindow->maxHead == pWindow->maxTail)
+		return 0;
+	
+	return pWindow->code[WINDOW_POS(pWindow->maxDq[WINDOW_POS(pWindow->maxHead)])];
+}
+
+
+/*!
+	\brief Среднее значение отсчётов окна
+	\param pWindow	Указатель на окно
+	\return Среднее, 0 для пустого окна
+ */
+float AD74413R_windowMean(const tWindow *pWindow)
+{
+	uint16_t	count	=	AD74413R_windowCount(pWindow);
+	
+	return (count != 0)?((float)pWindow->sum / count):0.0f;
+}
+///@}
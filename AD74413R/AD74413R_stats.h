@@ -0,0 +1,82 @@
+#ifndef AD74413R_STATS_H
+	#define AD74413R_STATS_H
+	
+	#include <stdint.h>
+	#include <stdbool.h>
+	
+	
+	#define AD74413R_STATS_HIST_BUCKETS		8			///< Количество корзин гистограммы
+	#define AD74413R_STATS_MEAN_SHIFT			16		///< Дробные разряды среднего (Q16)
+	#ifndef AD74413R_WINDOW_SIZE
+	#define AD74413R_WINDOW_SIZE					32		///< Ёмкость окна отсчётов (степень двойки, не больше 2^15)
+	#endif
+	#if (AD74413R_WINDOW_SIZE < 2) || (AD74413R_WINDOW_SIZE > 32768) || (AD74413R_WINDOW_SIZE & (AD74413R_WINDOW_SIZE - 1))
+	#error "AD74413R_WINDOW_SIZE должна быть степенью двойки от 2 до 2^15"
+	#endif
+	
+	
+	/*!
+		\brief Потоковая статистика по целочисленным отсчётам (алгоритм Уэлфорда)
+	 */
+	typedef struct
+	{
+		uint32_t					count;			///< Количество учтённых отсчётов
+		uint32_t					limit;			///< Предельное количество отсчётов, 0 - без ограничения
+		int64_t						meanQ16;		///< Среднее в формате Q16
+		uint64_t					m2Q16;			///< Сумма квадратов отклонений в формате Q16
+		int32_t						min;				///< Минимальный отсчёт
+		int32_t						max;				///< Максимальный отсчёт
+		bool							histEn;			///< Гистограмма включена
+		int32_t						histMin;		///< Нижняя граница первой корзины
+		uint8_t						histShift;	///< Ширина корзины 2^histShift
+		uint32_t					hist[AD74413R_STATS_HIST_BUCKETS];	///< Гистограмма
+		volatile uint16_t	resetReq;		///< Счётчик запросов сброса
+		uint16_t					resetAck;		///< Счётчик выполненных сбросов
+	}tStats;
+	
+	
+	/*!
+		\brief Скользящее окно последних отсчётов
+		\details Индексы в окне и очередях - порядковые номера отсчётов по модулю 2^16,
+							позиция в буфере - номер по модулю AD74413R_WINDOW_SIZE
+	 */
+	typedef struct
+	{
+		uint16_t					code[AD74413R_WINDOW_SIZE];		///< Отсчёты
+		uint32_t					ms[AD74413R_WINDOW_SIZE];			///< Время отсчётов, мс
+		uint16_t					first;				///< Номер самого старого отсчёта в окне
+		uint16_t					next;					///< Номер следующего отсчёта
+		uint32_t					sum;					///< Сумма отсчётов окна
+		uint32_t					windowMs;			///< Длительность окна, мс; 0 - только по ёмкости
+		uint16_t					minDq[AD74413R_WINDOW_SIZE];	///< Очередь кандидатов в минимум (возрастающая)
+		uint16_t					minHead;
+		uint16_t					minTail;
+		uint16_t					maxDq[AD74413R_WINDOW_SIZE];	///< Очередь кандидатов в максимум (убывающая)
+		uint16_t					maxHead;
+		uint16_t					maxTail;
+		volatile uint16_t	resetReq;			///< Счётчик запросов сброса
+		uint16_t					resetAck;			///< Счётчик выполненных сбросов
+	}tWindow;
+	
+	
+	// Прототипы функций
+	void			AD74413R_statsInit(tStats *pStats, uint32_t limit);
+	void			AD74413R_statsRequestReset(tStats *pStats);
+	void			AD74413R_statsSetHistogram(tStats *pStats, int32_t histMin, uint8_t histShift);
+	void			AD74413R_statsUpdate(tStats *pStats, int32_t sample);
+	
+	float			AD74413R_statsMean(const tStats *pStats);
+	float			AD74413R_statsVariance(const tStats *pStats);
+	
+	void			AD74413R_windowInit(tWindow *pWindow, uint32_t windowMs);
+	void			AD74413R_windowRequestReset(tWindow *pWindow);
+	void			AD74413R_windowPush(tWindow *pWindow, uint16_t code, uint32_t ms);
+	
+	uint16_t	AD74413R_windowCount(const tWindow *pWindow);
+	uint32_t	AD74413R_windowSpanMs(const tWindow *pWindow);
+	uint16_t	AD74413R_windowMin(const tWindow *pWindow);
+	uint16_t	AD74413R_windowMax(const tWindow *pWindow);
+	float			AD74413R_windowMean(const tWindow *pWindow);
+	
+
+#endif